@@ -1,4 +1,7 @@
 ﻿#include "CirclePackingManager.h"
+#include "GeneratorSnapshotFile.h"
+#include "GeneratorTextureUtils.h"
+#include "Engine/Texture2D.h"
 
 ACirclePackingManager::ACirclePackingManager()
 {
@@ -17,117 +20,302 @@ void ACirclePackingManager::BeginPlay()
     InstancedMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
     InstancedMesh->SetVisibility(true);
     InstancedMesh->NumCustomDataFloats = 4;
+
+    GenCore::FCirclePackingParams Params;
+    Params.Mode = static_cast<GenCore::ECirclePackingMode>(PackingEngine);
+    Params.CanvasSize = CanvasSize;
+    Params.MinTargetRadius = MinTargetRadius;
+    Params.MaxTargetRadius = MaxTargetRadius;
+
+    TArray<float> Luminance;
+    FIntPoint MaskSize;
+    if (MaskTexture && GeneratorTexture::ReadLuminance(MaskTexture, Luminance, MaskSize))
+    {
+        std::vector<float> Weights(Luminance.Num());
+        for (int32 i = 0; i < Luminance.Num(); ++i)
+        {
+            Weights[i] = Luminance[i] >= MaskThreshold ? Luminance[i] : 0.f;
+        }
+        // Darts are drawn from the mask's pyramid, radii capped by its edge distance
+        auto Mask = std::make_shared<GenCore::FCirclePackingMask>();
+        Mask->Build(Weights, MaskSize.X, MaskSize.Y);
+        if (Mask->IsEmpty())
+            UE_LOG(LogTemp, Warning, TEXT("%s: MaskTexture %s has nothing above MaskThreshold"), *GetName(), *MaskTexture->GetName());
+        else
+            Params.Mask = Mask;
+    }
+    Packer.Reset(Params, RandomSeed != 0 ? static_cast<uint64>(RandomSeed) : FPlatformTime::Cycles64());
+
+    if (bRecordReplay)
+        Recorder.Start();
+
+    if (bLoadSnapshotOnBeginPlay)
+        LoadSnapshot();
+    else if (bPlayReplayOnBeginPlay)
+        PlayReplay();
+
+    if (bUseGeneratorSubsystem && IsActorTickEnabled() && !bReplaying)
+        UGeneratorSubsystem::RegisterActorJob(this, this);
+}
+
+void ACirclePackingManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    UGeneratorSubsystem::UnregisterActorJob(this, this);
+    if (Recorder.IsRecording() && Recorder.Num() > 0)
+        SaveReplay();
+    Super::EndPlay(EndPlayReason);
 }
 
 void ACirclePackingManager::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
 
+    if (bReplaying)
+    {
+        TickReplay(DeltaTime);
+        return;
+    }
+
+    if (!PrepareGeneratorJob(DeltaTime))
+        return;
+
+    SimulateGeneratorJob(DeltaTime);
+    ApplyGeneratorJob();
+}
+
+bool ACirclePackingManager::PrepareGeneratorJob(float DeltaTime)
+{
+    SimulationScale = Throttle.Evaluate(this, Significance, DeltaTime);
+    if (SimulationScale <= 0.f)
+        return false;
+
+    Recorder.BeginFrame(GetWorld()->GetTimeSeconds());
+    return true;
+}
+
+void ACirclePackingManager::SimulateGeneratorJob(float DeltaTime)
+{
     //TimeAccumulator += DeltaTime;
     //if (TimeAccumulator < SimulationStepRate)
     //    return;
 
     //TimeAccumulator = 0.f;
 
-    TrySpawnNewCircle();
+    // One spawn + growth step per StepInterval of play, so frames the subsystem deferred are made up here;
+    // throttled it runs less often, catching up several at once (within GeneratorJob::MaxStepsPerRun).
+    StepCredit += DeltaTime * SimulationScale;
+    const int32 Steps = GeneratorJob::ConsumeSteps(StepCredit, StepInterval);
+    for (int32 Step = 0; Step < Steps; ++Step)
+    {
+        const int32 Spawned = Packer.TrySpawnNewCircle();
+
+        /*Grows toward its target size(like a balloon inflating).
+        Gets older.*/
+        Packer.Advance(SimulationStepRate);
+
+        if (Recorder.IsRecording())
+            RecordStep(Spawned);
+    }
+}
+
+void ACirclePackingManager::ApplyGeneratorJob()
+{
+    UpdateInstances();
+}
 
+void ACirclePackingManager::UpdateInstances()
+{
     InstancedMesh->ClearInstances();
 
-    for (int32 i = 0; i < Circles.Num(); ++i)
+    for (const GenCore::FCircle& Circle : Packer.GetCircles())
     {
-        FCircleData& Circle = Circles[i];
+        int32 Index = InstancedMesh->AddInstance(GetInstanceTransform(Circle));
+        InstancedMesh->SetCustomData(Index, GetInstanceCustomData(Circle, Packer.GetAge(Circle)));
+    }
+}
 
-        /*Grows toward its target size(like a balloon inflating).
+FTransform ACirclePackingManager::GetInstanceTransform(const GenCore::FCircle& Circle)
+{
+    FVector Loc = FVector(Circle.Position.X, Circle.Position.Y, Circle.Radius * 0.02f);
+    FVector Scale = FVector(Circle.Radius / 50.f, Circle.Radius / 50.f, 0.05f);
+    return FTransform(FRotator::ZeroRotator, Loc, Scale);
+}
 
-        Gets older.
+TArray<float> ACirclePackingManager::GetInstanceCustomData(const GenCore::FCircle& Circle, float Age)
+{
+    // Color and its glow (emissive)
+    return {
+        Circle.Color.R,
+        Circle.Color.G,
+        Circle.Color.B,
+        GenCore::FCirclePacker::ComputeEmissive(Circle, Age)
+    };
+}
 
-        Its 3D mesh is scaled and positioned in the world.
+void ACirclePackingManager::RecordStep(int32 Spawned)
+{
+    const std::vector<GenCore::FCircle>& Circles = Packer.GetCircles();
+    if (Spawned >= 0)
+    {
+        const GenCore::FCircle& Circle = Circles[Spawned];
+        GenCore::FReplayEvent Event;
+        Event.Position = GenCore::FVec3(Circle.Position.X, Circle.Position.Y, 0.f);
+        Event.Size = Circle.TargetRadius;
+        Event.R = GenCore::ToUnorm8(Circle.Color.R);
+        Event.G = GenCore::ToUnorm8(Circle.Color.G);
+        Event.B = GenCore::ToUnorm8(Circle.Color.B);
+        Recorder.Record(Event);
+    }
 
-        Its glow(emissive)*/
+    // GrowUntilContact: the circles that just touched a neighbour stop at this size
+    for (const int32 Index : Packer.GetSettled())
+    {
+        GenCore::FReplayEvent Event;
+        Event.Type = GenCore::EReplayEventType::Settle;
+        Event.Position = GenCore::FVec3(Circles[Index].Position.X, Circles[Index].Position.Y, 0.f);
+        Event.Size = Circles[Index].TargetRadius;
+        Event.Id = Index;
+        Recorder.Record(Event);
+    }
+}
 
-        // Grow
-        if (Circle.Radius < Circle.TargetRadius)
-            Circle.Radius = FMath::Min(Circle.Radius + Circle.GrowthRate * SimulationStepRate, Circle.TargetRadius);
+bool ACirclePackingManager::SaveReplay() const
+{
+    return Recorder.Save(GeneratorReplay::ResolvePath(this, ReplayPath), Player);
+}
 
-        // Age
-        Circle.Age += SimulationStepRate;
+bool ACirclePackingManager::PlayReplay()
+{
+    if (!Player.Open(GeneratorReplay::ResolvePath(this, ReplayPath)))
+        return false;
 
-        // Transform
-        FVector Loc = FVector(Circle.Position.X, Circle.Position.Y, Circle.Radius * 0.02f);
-        FVector Scale = FVector(Circle.Radius / 50.f, Circle.Radius / 50.f, 0.05f);
-        //FRotator Rot(0.f, 0.f, Circle.Age * 30.f);
-        FTransform InstanceTransform(FRotator::ZeroRotator, Loc, Scale);
-        int32 Index = InstancedMesh->AddInstance(InstanceTransform);
+    // Whatever was recorded so far (e.g. the BeginPlay seeds) is not what will be on screen
+    Recorder.Discard();
 
-        float Emissive = 0.f;
+    UGeneratorSubsystem::UnregisterActorJob(this, this);
+    InstancedMesh->ClearInstances();
+    ReplayCircles.Reset();
+    ReplayAnimating.Reset();
+    ReplayClock = 0.f;
+    bReplaying = true;
+    bShowingReplay = true;
+    SetActorTickEnabled(true);
+    return true;
+}
 
-        if (Circle.Radius < Circle.TargetRadius)
-        {
-            // Growing → ramp up
-            Emissive = FMath::Clamp(Circle.Radius / Circle.TargetRadius * 0.6f, 0.f, 0.6f);
-        }
-        else
+void ACirclePackingManager::TickReplay(float DeltaTime)
+{
+    const float GrowthRate = Packer.GetParams().GrowthRate;
+    Player.Advance(DeltaTime, ReplaySpeed, [this, GrowthRate](const GenCore::FReplayEvent& Event)
         {
-            // Fully grown → fade over 5 seconds
-            Emissive = FMath::Clamp((1.f - (Circle.Age - (Circle.TargetRadius / Circle.GrowthRate)) / 5.f) * 0.6f, 0.f, 0.6f);
-        }
+            if (Event.Type == GenCore::EReplayEventType::Settle)
+            {
+                if (ReplayCircles.IsValidIndex(Event.Id))
+                {
+                    // Growth here is paced by play time, events by recorded time; after a throttled recording a circle
+                    // can be past its contact size when the event arrives. It then stops where it is rather than shrink.
+                    GenCore::FCircle& Circle = ReplayCircles[Event.Id];
+                    Circle.TargetRadius = FMath::Max(Event.Size, Circle.Radius);
+                }
+                return;
+            }
 
-        TArray<float> CustomData = {
-            Circle.Color.R,
-            Circle.Color.G,
-            Circle.Color.B,
-            Emissive
-        };
+            GenCore::FCircle Circle;
+            Circle.Position = GenCore::FVec2(Event.Position.X, Event.Position.Y);
+            Circle.TargetRadius = Event.Size;
+            Circle.GrowthRate = GrowthRate;
+            Circle.SpawnTime = ReplayClock;
+            Circle.Color = GenCore::FColor3(Event.R / 255.f, Event.G / 255.f, Event.B / 255.f);
+            Circle.ID = ReplayCircles.Add(Circle);
+            InstancedMesh->AddInstance(GetInstanceTransform(Circle));
+            ReplayAnimating.Add(Circle.ID);
+        });
+
+    // Same growth and glow as the simulation, paced by play time rather than frames: the simulation advances
+    // SimulationStepRate of growth every StepInterval seconds.
+    const float StepTime = DeltaTime * FMath::Max(ReplaySpeed, 0.f) * SimulationStepRate / FMath::Max(StepInterval, KINDA_SMALL_NUMBER);
+    ReplayClock += StepTime;
+    int32 Kept = 0;
+    const int32 NumAnimating = ReplayAnimating.Num();
+    for (int32 i = 0; i < NumAnimating; ++i)
+    {
+        const int32 Index = ReplayAnimating[i];
+        GenCore::FCircle& Circle = ReplayCircles[Index];
+        Circle.Radius = FMath::Min(Circle.Radius + Circle.GrowthRate * StepTime, Circle.TargetRadius);
+        const float Age = ReplayClock - Circle.SpawnTime;
+        InstancedMesh->UpdateInstanceTransform(Index, GetInstanceTransform(Circle), false, false);
+        // One render state update for the whole batch, and none once nothing animates
+        InstancedMesh->SetCustomData(Index, GetInstanceCustomData(Circle, Age), /*bMarkRenderStateDirty*/ i == NumAnimating - 1);
 
-        InstancedMesh->SetCustomData(Index, CustomData);
+        // Done once fully grown and the glow has faded
+        if (Circle.Radius < Circle.TargetRadius || GenCore::FCirclePacker::ComputeEmissive(Circle, Age) > 0.f)
+            ReplayAnimating[Kept++] = Index;
     }
-}
+    ReplayAnimating.SetNum(Kept, EAllowShrinking::No);
 
-bool ACirclePackingManager::IsOverlapping(const FVector2D& Pos, float Radius) const
-{
-	for (const FCircleData& Other : Circles)
-	{
-        //Measure how far it is from the new circle
-		float DistSq = FVector2D::DistSquared(Other.Position, Pos);
-        //If distance < (both radii added together): they touch → return true.
-		float MinDist = Radius + Other.TargetRadius;
-		if (DistSq < MinDist * MinDist)
-			return true;
-	}
-    return false;
+    if (!Player.IsPlaying() && ReplayAnimating.Num() == 0)
+    {
+        bReplaying = false;
+        SetActorTickEnabled(false);
+    }
 }
 
-void ACirclePackingManager::TrySpawnNewCircle()
+bool ACirclePackingManager::SaveSnapshot() const
 {
-	/*Try MaxAttempts times:
-	-Pick a random position inside the box.
-		- Choose a random size(mostly small).
-		- If it doesn’t touch any other circle(IsOverlapping is false) :
-		→ Save it.
-		→ Stop trying.*/
+    std::vector<GenCore::FSnapshotCircle> Records;
+    Records.reserve(bShowingReplay ? ReplayCircles.Num() : Packer.GetCircles().size());
+    auto AddRecords = [&Records](const auto& Circles)
+        {
+            for (const GenCore::FCircle& Circle : Circles)
+            {
+                Records.push_back({ Circle.Position.X, Circle.Position.Y, Circle.Radius, Circle.TargetRadius,
+                    GenCore::ToUnorm8(Circle.Color.R), GenCore::ToUnorm8(Circle.Color.G), GenCore::ToUnorm8(Circle.Color.B), 255 });
+            }
+        };
+    // Whatever is on screen: a replay (even mid-way) or the packer's own layout
+    if (bShowingReplay)
+        AddRecords(ReplayCircles);
+    else
+        AddRecords(Packer.GetCircles());
 
-    const int32 MaxAttempts = 500;
-    for (int32 i = 0; i < MaxAttempts; ++i)
-    {
-        FVector2D TryPos = FVector2D(
-            FMath::FRandRange(-CanvasSize, CanvasSize),
-            FMath::FRandRange(-CanvasSize, CanvasSize)
-        );
+    GenCore::FSnapshotWriter Writer;
+    Writer.AddSection(Records);
+    return GeneratorSnapshot::WriteFile(GeneratorSnapshot::ResolvePath(this, SnapshotPath), Writer);
+}
 
-        float ExponentBias = 0.01f; // Lower = more tiny, rarer big
-        float Alpha = FMath::FRand();
-        float fRandRange = MinTargetRadius + -FMath::Loge(1.f - Alpha) / ExponentBias;
-        fRandRange = FMath::Clamp(fRandRange, MinTargetRadius, MaxTargetRadius);
+bool ACirclePackingManager::LoadSnapshot()
+{
+    FGeneratorSnapshotReader Reader;
+    if (!Reader.Open(GeneratorSnapshot::ResolvePath(this, SnapshotPath)))
+        return false;
+    // A recording would not match the loaded layout
+    Recorder.Discard();
 
-        if (!IsOverlapping(TryPos, fRandRange))
+    Packer.Reset(Packer.GetParams(), 0);
+    bShowingReplay = false;
+    ReplayCircles.Reset();
+    ReplayAnimating.Reset();
+    Reader.ForEachBatch<GenCore::FSnapshotCircle>(0, SnapshotMaxRecords, [this](const GenCore::FSnapshotCircle* Records, int64 Count)
         {
-            FCircleData NewCircle;
-            NewCircle.Position = TryPos;
-            NewCircle.TargetRadius = fRandRange;
-            NewCircle.ID = Circles.Num();
-            NewCircle.Color = FLinearColor::MakeRandomColor();
-            Circles.Add(NewCircle);
-            break;
-        }
-    }
-}
\ No newline at end of file
+            for (int64 i = 0; i < Count; ++i)
+            {
+                GenCore::FCircle Circle;
+                Circle.Position = GenCore::FVec2(Records[i].X, Records[i].Y);
+                Circle.Radius = Records[i].Radius;
+                Circle.TargetRadius = Records[i].TargetRadius;
+                Circle.Color = GenCore::FColor3(Records[i].R / 255.f, Records[i].G / 255.f, Records[i].B / 255.f);
+                Circle.GrowthRate = Packer.GetParams().GrowthRate;
+                // Loaded circles are settled: spawned long enough before the (reset) clock to be past their glow fade.
+                Circle.SpawnTime = Packer.GetClock() - (Circle.TargetRadius / Circle.GrowthRate + 5.f);
+                Packer.AddCircle(Circle);
+            }
+        });
+
+    // The layout is final, no more spawning or growing.
+    bReplaying = false;
+    Player.Stop();
+    UpdateInstances();
+    SetActorTickEnabled(false);
+    UGeneratorSubsystem::UnregisterActorJob(this, this);
+    return true;
+}
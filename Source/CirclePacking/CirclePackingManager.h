@@ -3,58 +3,162 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Components/InstancedStaticMeshComponent.h"
+#include "Core/CirclePackingCore.h"
+#include "GeneratorReplayFile.h"
+#include "GeneratorSignificance.h"
+#include "GeneratorSubsystem.h"
 #include "CirclePackingManager.generated.h"
 
+class UTexture2D;
 
-USTRUCT()
-struct FCircleData
+// Same order as GenCore::ECirclePackingMode
+UENUM()
+enum class ECirclePackingEngine : uint8
 {
-    GENERATED_BODY()
-
-    FVector2D Position;
-    float Radius = 0.f;
-    float TargetRadius = 50.f;
-    float GrowthRate = 20.f;
-
-    int32 ID = -1;
-    float Age = 0.f;
-    FLinearColor Color = FLinearColor::White;
+    // Random darts, rejected on overlap
+    RandomRejection,
+    // Tangent placement along an advancing front: dense and deterministic
+    FrontChain,
+    // Nothing reserved: circles grow until they touch a neighbour
+    GrowUntilContact,
 };
 
-
 UCLASS()
-class CIRCLEPACKING_API ACirclePackingManager : public AActor
+class CIRCLEPACKING_API ACirclePackingManager : public AActor, public IGeneratorJob
 {
 	GENERATED_BODY()
 	
 public:
 	ACirclePackingManager();
 
+    UFUNCTION(BlueprintCallable, Category = "Snapshot")
+    bool SaveSnapshot() const;
+
+    UFUNCTION(BlueprintCallable, Category = "Snapshot")
+    bool LoadSnapshot();
+
+    UFUNCTION(BlueprintCallable, Category = "Replay")
+    bool SaveReplay() const;
+
+    // Clears the canvas and plays the saved replay back instead of simulating: no darts, no overlap tests.
+    UFUNCTION(BlueprintCallable, Category = "Replay")
+    bool PlayReplay();
+
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void Tick(float DeltaTime) override;
 
+    // IGeneratorJob
+    virtual void SimulateGeneratorJob(float DeltaTime) override;
+    virtual void ApplyGeneratorJob() override;
+    virtual bool PrepareGeneratorJob(float DeltaTime) override;
+    virtual int32 GetGeneratorPriority() const override { return GeneratorPriority; }
+
     UPROPERTY(EditAnywhere)
     UStaticMesh* CircleMesh;
 
     UPROPERTY(EditAnywhere)
     float CanvasSize = 1500.f;
 
+    UPROPERTY(EditAnywhere)
+    ECirclePackingEngine PackingEngine = ECirclePackingEngine::RandomRejection;
+
+    // Pack inside this image's shape (RandomRejection and GrowUntilContact): its brightness scales the circles, which
+    // never cross its edge. The image spans the canvas along its longer side. Needs an uncompressed texture
+    // (see GeneratorTexture::ReadLuminance).
+    UPROPERTY(EditAnywhere, Category = "Mask")
+    UTexture2D* MaskTexture = nullptr;
+
+    // Darker texels are outside the shape
+    UPROPERTY(EditAnywhere, Category = "Mask", meta = (ClampMin = "0", ClampMax = "1"))
+    float MaskThreshold = 0.1f;
+
     UPROPERTY(VisibleAnywhere)
     UInstancedStaticMeshComponent* InstancedMesh;
 
+    // Let the world's generator subsystem schedule this actor (simulation on a worker task, shared frame budget)
+    // instead of ticking it.
+    UPROPERTY(EditAnywhere, Category = "Scheduling")
+    bool bUseGeneratorSubsystem = false;
+
+    UPROPERTY(EditAnywhere, Category = "Scheduling", meta = (EditCondition = "bUseGeneratorSubsystem"))
+    int32 GeneratorPriority = 0;
+
+    // Slow down or pause while far away or off-screen, and catch up once relevant again.
+    UPROPERTY(EditAnywhere, Category = "Significance")
+    FGeneratorSignificanceSettings Significance;
+
+    // Empty = Saved/Snapshots/<ActorName>.gensnap
+    UPROPERTY(EditAnywhere, Category = "Snapshot")
+    FString SnapshotPath;
+
+    // Skip the simulation and map the saved circles straight into the instances.
+    UPROPERTY(EditAnywhere, Category = "Snapshot")
+    bool bLoadSnapshotOnBeginPlay = false;
+
+    // Load at most this many records (0 = all), e.g. for a partial preview of a huge file.
+    UPROPERTY(EditAnywhere, Category = "Snapshot")
+    int32 SnapshotMaxRecords = 0;
+
+    // Record every spawn (and each GrowUntilContact circle's final size) for PlayReplay; saved on EndPlay.
+    UPROPERTY(EditAnywhere, Category = "Replay")
+    bool bRecordReplay = false;
+
+    // Empty = Saved/Replays/<ActorName>.genreplay
+    UPROPERTY(EditAnywhere, Category = "Replay")
+    FString ReplayPath;
+
+    UPROPERTY(EditAnywhere, Category = "Replay")
+    bool bPlayReplayOnBeginPlay = false;
+
+    // 1 = the recorded pace. Growth and glow speed up with it.
+    UPROPERTY(EditAnywhere, Category = "Replay", meta = (ClampMin = "0"))
+    float ReplaySpeed = 1.f;
+
 private:
-    TArray<FCircleData> Circles;
-    bool IsOverlapping(const FVector2D& Pos, float Radius) const;
-    void TrySpawnNewCircle();
+    // The packing itself lives in the engine-independent core; this actor only presents it.
+    GenCore::FCirclePacker Packer;
+    void UpdateInstances();
+    static FTransform GetInstanceTransform(const GenCore::FCircle& Circle);
+    static TArray<float> GetInstanceCustomData(const GenCore::FCircle& Circle, float Age);
+
+    FGeneratorReplayRecorder Recorder;
+    void RecordStep(int32 Spawned);
+
+    // Playback keeps its own circles in instance order and only touches the ones still growing or glowing,
+    // so a frame costs the events it emits plus the few circles they are animating.
+    FGeneratorReplayPlayer Player;
+    bool bReplaying = false;
+    TArray<GenCore::FCircle> ReplayCircles;
+    TArray<int32> ReplayAnimating;
+    // Growth time played back so far; replayed circles spawn at it, like the packer's clock
+    float ReplayClock = 0.f;
+    // Set by PlayReplay: the layout on screen is ReplayCircles (playing or finished), not the packer's
+    bool bShowingReplay = false;
+    void TickReplay(float DeltaTime);
+
+    FGeneratorThrottle Throttle;
+    // Frames' worth of simulation for this frame (see FGeneratorThrottle)
+    float SimulationScale = 1.f;
+    // Seconds owed; whole steps are run, the fraction carries over
+    float StepCredit = 0.f;
 
     float TimeAccumulator = 0.f;
 	UPROPERTY(EditAnywhere)
 	float SimulationStepRate = 0.1f;
 
+    // Seconds of play per spawn + growth step (one per frame at 60 fps)
+    UPROPERTY(EditAnywhere, meta = (ClampMin = "0.001"))
+    float StepInterval = 1.f / 60.f;
+
     UPROPERTY(EditAnywhere)
     float MinTargetRadius = 1.f;
 
     UPROPERTY(EditAnywhere)
     float MaxTargetRadius = 300.f;
+
+    // 0 = new layout every play
+    UPROPERTY(EditAnywhere)
+    int32 RandomSeed = 0;
 };
@@ -0,0 +1,658 @@
+#include "CirclePackingCore.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace GenCore
+{
+    void FCirclePacker::Reset(const FCirclePackingParams& InParams, uint64_t Seed)
+    {
+        Params = InParams;
+        Random.Initialize(Seed);
+        Circles.clear();
+        Clock = 0.f;
+
+        // Mean of the exponential radius distribution, as a diameter
+        const float MeanRadius = std::min(Params.MinTargetRadius + 1.f / std::max(Params.ExponentBias, 1e-6f), Params.MaxTargetRadius);
+        CellSize = std::max(2.f * MeanRadius, 1.f);
+        Grid.clear();
+        Growing.clear();
+        Settled.clear();
+
+        FrontNext.clear();
+        FrontPrev.clear();
+        FrontState.clear();
+        FrontLength = 0;
+        FrontQueue = decltype(FrontQueue)();
+        OverlapMark.clear();
+        OverlapPass = 0;
+    }
+
+    float FCirclePacker::SampleTargetRadius()
+    {
+        // Exponential distribution: mostly small circles, the odd big one.
+        const float Alpha = Random.FRand();
+        const float Radius = Params.MinTargetRadius + -std::log(1.f - Alpha) / Params.ExponentBias;
+        return std::min(std::max(Radius, Params.MinTargetRadius), Params.MaxTargetRadius);
+    }
+
+    int32_t FCirclePacker::TrySpawnNewCircle()
+    {
+        switch (Params.Mode)
+        {
+        case ECirclePackingMode::FrontChain:       return TrySpawnFrontChain();
+        case ECirclePackingMode::GrowUntilContact: return TrySpawnGrowing();
+        default:                                   return TrySpawnRandom();
+        }
+    }
+
+    int32_t FCirclePacker::TrySpawnRandom()
+    {
+        /*Try MaxAttempts times:
+        -Pick a random position inside the box.
+            - Choose a random size(mostly small).
+            - If it doesn't touch any other circle(IsOverlapping is false) :
+            → Save it.
+            → Stop trying.*/
+        for (int32_t i = 0; i < Params.MaxAttempts; ++i)
+        {
+            FVec2 TryPos;
+            float TargetRadius = 0.f;
+            if (!ThrowDart(TryPos, TargetRadius))
+                continue;
+
+            if (!IsOverlapping(TryPos, TargetRadius))
+                return PushCircle(TryPos, TargetRadius);
+        }
+        return -1;
+    }
+
+    bool FCirclePacker::ThrowDart(FVec2& OutPos, float& OutTargetRadius)
+    {
+        if (!Params.Mask)
+        {
+            OutPos = FVec2(
+                Random.FRandRange(-Params.CanvasSize, Params.CanvasSize),
+                Random.FRandRange(-Params.CanvasSize, Params.CanvasSize));
+            OutTargetRadius = SampleTargetRadius();
+            return true;
+        }
+
+        const FCirclePackingMask& Mask = *Params.Mask;
+        FVec2 Texel;
+        if (!Mask.Sample(Random, Texel))
+            return false;
+
+        // Canvas units per texel; the longer image side spans the canvas
+        const float Scale = 2.f * Params.CanvasSize / static_cast<float>(std::max(Mask.GetWidth(), Mask.GetHeight()));
+        OutPos = (Texel - FVec2(0.5f * Mask.GetWidth(), 0.5f * Mask.GetHeight())) * Scale;
+        // Strokes thinner than the smallest circle still get circles, as large as fits
+        const float Sized = std::max(SampleTargetRadius() * Mask.GetWeight(Texel), Params.MinTargetRadius);
+        OutTargetRadius = std::min(Sized, Mask.GetEdgeDistance(Texel) * Scale);
+        return OutTargetRadius > 0.f;
+    }
+
+    int32_t FCirclePacker::TrySpawnGrowing()
+    {
+        for (int32_t i = 0; i < Params.MaxAttempts; ++i)
+        {
+            FVec2 TryPos;
+            float TargetRadius = 0.f;
+            if (!ThrowDart(TryPos, TargetRadius))
+                continue;
+
+            // Room for at least the smallest circle next to what is there now
+            bool bBlocked = false;
+            const float Clearance = std::min(Params.MinTargetRadius, TargetRadius);
+            const FVec2 Reach(Clearance, Clearance);
+            ForEachInBox(TryPos - Reach, TryPos + Reach, [&](int32_t Index)
+                {
+                    const FCircle& Other = Circles[Index];
+                    const float MinDist = Clearance + Other.Radius;
+                    bBlocked = bBlocked || FVec2::DistSquared(Other.Position, TryPos) < MinDist * MinDist;
+                });
+            if (bBlocked)
+                continue;
+
+            const int32_t Index = PushCircle(TryPos, TargetRadius);
+            Growing.push_back(Index);
+            return Index;
+        }
+        return -1;
+    }
+
+    namespace
+    {
+        // Center of a circle of Radius touching A and B, on the right of A→B (outside a counter-clockwise front).
+        FVec2 TangentPosition(const FCircle& A, const FCircle& B, float Radius)
+        {
+            const FVec2 AB = B.Position - A.Position;
+            const float D = std::max(std::sqrt(AB.X * AB.X + AB.Y * AB.Y), 1e-6f);
+            const float DA = A.TargetRadius + Radius;
+            const float DB = B.TargetRadius + Radius;
+            // Distance along A→B, then out to the right
+            const float Along = (DA * DA - DB * DB + D * D) / (2.f * D);
+            const float Out = std::sqrt(std::max(DA * DA - Along * Along, 0.f));
+            const FVec2 Dir = AB * (1.f / D);
+            return A.Position + Dir * Along + FVec2(Dir.Y, -Dir.X) * Out;
+        }
+    }
+
+    int32_t FCirclePacker::TrySpawnFrontChain()
+    {
+        const float TargetRadius = SampleTargetRadius();
+        auto IsInCanvas = [this](const FVec2& Pos)
+            {
+                return std::fabs(Pos.X) <= Params.CanvasSize && std::fabs(Pos.Y) <= Params.CanvasSize;
+            };
+
+        // Seed the front with three mutually touching circles around the center.
+        if (Circles.size() < 3)
+        {
+            FVec2 Pos;
+            if (Circles.size() == 1)
+                Pos = Circles[0].Position + FVec2(Circles[0].TargetRadius + TargetRadius, 0.f);
+            else if (Circles.size() == 2)
+                Pos = TangentPosition(Circles[1], Circles[0], TargetRadius);
+            if (!IsInCanvas(Pos))
+                return -1;
+
+            const int32_t Index = PushCircle(Pos, TargetRadius);
+            if (Index == 2)
+            {
+                AddToFront(0, 2, 1);
+                AddToFront(1, 0, 2);
+                AddToFront(2, 1, 0);
+            }
+            return Index;
+        }
+
+        while (!FrontQueue.empty())
+        {
+            const int32_t Nearest = FrontQueue.top().second;
+            if (FrontState[Nearest] != EFrontState::On)
+            {
+                FrontQueue.pop();
+                continue;
+            }
+
+            // Every retry cuts at least one circle from the front, so this ends.
+            int32_t M = Nearest;
+            int32_t N = FrontNext[M];
+            for (;;)
+            {
+                const FVec2 Pos = TangentPosition(Circles[M], Circles[N], TargetRadius);
+                if (!IsInCanvas(Pos))
+                {
+                    // No room left beside M
+                    if (FrontState[M] == EFrontState::On)
+                        FrontState[M] = EFrontState::Closed;
+                    break;
+                }
+
+                OverlapScratch.clear();
+                GetOverlapping(Pos, TargetRadius, OverlapScratch);
+                if (OverlapScratch.empty())
+                {
+                    const int32_t Index = PushCircle(Pos, TargetRadius);
+                    AddToFront(Index, M, N);
+                    return Index;
+                }
+
+                // Find the overlapped circle nearest along the front, after N or before M
+                ++OverlapPass;
+                for (const int32_t Other : OverlapScratch)
+                {
+                    OverlapMark[Other] = OverlapPass;
+                }
+                int32_t After = FrontNext[N];
+                int32_t Before = FrontPrev[M];
+                int32_t Hit = -1;
+                bool bHitAfter = false;
+                for (int32_t Walked = 0; Walked < FrontLength / 2 + 1 && Hit < 0; ++Walked)
+                {
+                    if (OverlapMark[After] == OverlapPass && After != M)
+                    {
+                        Hit = After;
+                        bHitAfter = true;
+                    }
+                    else if (OverlapMark[Before] == OverlapPass && Before != N)
+                    {
+                        Hit = Before;
+                    }
+                    After = FrontNext[After];
+                    Before = FrontPrev[Before];
+                }
+
+                if (Hit < 0)
+                {
+                    // Only circles behind the front are in the way
+                    if (FrontState[M] == EFrontState::On)
+                        FrontState[M] = EFrontState::Closed;
+                    break;
+                }
+
+                if (bHitAfter)
+                {
+                    CutFront(M, Hit);
+                    N = Hit;
+                }
+                else
+                {
+                    CutFront(Hit, N);
+                    M = Hit;
+                }
+            }
+        }
+        return -1;
+    }
+
+    void FCirclePacker::AddToFront(int32_t Index, int32_t Prev, int32_t Next)
+    {
+        FrontPrev[Index] = Prev;
+        FrontNext[Index] = Next;
+        FrontNext[Prev] = Index;
+        FrontPrev[Next] = Index;
+        FrontState[Index] = EFrontState::On;
+        ++FrontLength;
+        FrontQueue.push(std::make_pair(FVec2::DistSquared(Circles[Index].Position, FVec2()), Index));
+    }
+
+    void FCirclePacker::CutFront(int32_t From, int32_t To)
+    {
+        // Everything strictly between From and To leaves the front
+        for (int32_t Index = FrontNext[From]; Index != To; Index = FrontNext[Index])
+        {
+            FrontState[Index] = EFrontState::Off;
+            --FrontLength;
+        }
+        FrontNext[From] = To;
+        FrontPrev[To] = From;
+    }
+
+    int32_t FCirclePacker::PushCircle(const FVec2& Pos, float TargetRadius)
+    {
+        FCircle NewCircle;
+        NewCircle.Position = Pos;
+        NewCircle.TargetRadius = TargetRadius;
+        NewCircle.GrowthRate = Params.GrowthRate;
+        NewCircle.SpawnTime = Clock;
+        NewCircle.Color = HueToRgb(Random.FRand());
+        return AddCircle(NewCircle);
+    }
+
+    int32_t FCirclePacker::AddCircle(const FCircle& Circle)
+    {
+        Circles.push_back(Circle);
+        const int32_t Index = static_cast<int32_t>(Circles.size()) - 1;
+        Circles.back().ID = Index;
+
+        LinkCells(Index, Circle.TargetRadius);
+
+        FrontNext.push_back(-1);
+        FrontPrev.push_back(-1);
+        FrontState.push_back(EFrontState::Off);
+        OverlapMark.push_back(0);
+        return Index;
+    }
+
+    void FCirclePacker::LinkCells(int32_t Index, float Extent)
+    {
+        const FVec2 Reach(Extent, Extent);
+        const FVec2 Min = Circles[Index].Position - Reach;
+        const FVec2 Max = Circles[Index].Position + Reach;
+        for (int32_t CellX = ToCell(Min.X); CellX <= ToCell(Max.X); ++CellX)
+        {
+            for (int32_t CellY = ToCell(Min.Y); CellY <= ToCell(Max.Y); ++CellY)
+            {
+                Grid[CellKey(CellX, CellY)].push_back(Index);
+            }
+        }
+    }
+
+    void FCirclePacker::UnlinkCells(int32_t Index, float Extent)
+    {
+        const FVec2 Reach(Extent, Extent);
+        const FVec2 Min = Circles[Index].Position - Reach;
+        const FVec2 Max = Circles[Index].Position + Reach;
+        for (int32_t CellX = ToCell(Min.X); CellX <= ToCell(Max.X); ++CellX)
+        {
+            for (int32_t CellY = ToCell(Min.Y); CellY <= ToCell(Max.Y); ++CellY)
+            {
+                const auto Found = Grid.find(CellKey(CellX, CellY));
+                if (Found == Grid.end())
+                    continue;
+                std::vector<int32_t>& Cell = Found->second;
+                const auto It = std::find(Cell.begin(), Cell.end(), Index);
+                if (It != Cell.end())
+                {
+                    *It = Cell.back();
+                    Cell.pop_back();
+                }
+                if (Cell.empty())
+                    Grid.erase(Found);
+            }
+        }
+    }
+
+    template <typename VisitorType>
+    void FCirclePacker::ForEachInBox(const FVec2& Min, const FVec2& Max, VisitorType&& Visit) const
+    {
+        for (int32_t CellX = ToCell(Min.X); CellX <= ToCell(Max.X); ++CellX)
+        {
+            for (int32_t CellY = ToCell(Min.Y); CellY <= ToCell(Max.Y); ++CellY)
+            {
+                const auto Found = Grid.find(CellKey(CellX, CellY));
+                if (Found == Grid.end())
+                    continue;
+                for (const int32_t Index : Found->second)
+                {
+                    Visit(Index);
+                }
+            }
+        }
+    }
+
+    void FCirclePacker::Advance(float StepTime)
+    {
+        Clock += StepTime;
+        if (Params.Mode == ECirclePackingMode::GrowUntilContact)
+        {
+            AdvanceGrowing(StepTime);
+            return;
+        }
+
+        for (FCircle& Circle : Circles)
+        {
+            if (Circle.Radius < Circle.TargetRadius)
+                Circle.Radius = std::min(Circle.Radius + Circle.GrowthRate * StepTime, Circle.TargetRadius);
+        }
+    }
+
+    void FCirclePacker::AdvanceGrowing(float StepTime)
+    {
+        Settled.clear();
+
+        // Settled circles are never visited again; each growing one only meets the circles sharing its cells.
+        size_t Kept = 0;
+        for (const int32_t Index : Growing)
+        {
+            FCircle& Circle = Circles[Index];
+            float NewRadius = std::min(Circle.Radius + Circle.GrowthRate * StepTime, Circle.TargetRadius);
+            bool bTouched = false;
+
+            const FVec2 Reach(NewRadius, NewRadius);
+            ForEachInBox(Circle.Position - Reach, Circle.Position + Reach, [&](int32_t OtherIndex)
+                {
+                    if (OtherIndex == Index)
+                        return;
+                    const FCircle& Other = Circles[OtherIndex];
+                    const float MinDist = NewRadius + Other.Radius;
+                    const float DistSquared = FVec2::DistSquared(Other.Position, Circle.Position);
+                    if (DistSquared < MinDist * MinDist)
+                    {
+                        // Stop right at the contact (never shrink)
+                        NewRadius = std::max(std::sqrt(DistSquared) - Other.Radius, Circle.Radius);
+                        bTouched = true;
+                    }
+                });
+
+            Circle.Radius = NewRadius;
+            if (bTouched)
+            {
+                // The contact size is final: shrink the footprint and let the glow fade from here
+                UnlinkCells(Index, Circle.TargetRadius);
+                Circle.TargetRadius = Circle.Radius;
+                LinkCells(Index, Circle.TargetRadius);
+                Settled.push_back(Index);
+            }
+            else if (Circle.Radius < Circle.TargetRadius)
+            {
+                Growing[Kept++] = Index;
+            }
+        }
+        Growing.resize(Kept);
+    }
+
+    bool FCirclePacker::IsOverlapping(const FVec2& Pos, float Radius) const
+    {
+        // Every disc touching (Pos, Radius) is listed in a cell its box covers.
+        bool bOverlaps = false;
+        const FVec2 Reach(Radius, Radius);
+        ForEachInBox(Pos - Reach, Pos + Reach, [&](int32_t Index)
+            {
+                // Circles reserve their full target size, so a newcomer can never be overgrown later.
+                const FCircle& Other = Circles[Index];
+                const float MinDist = Radius + Other.TargetRadius;
+                bOverlaps = bOverlaps || FVec2::DistSquared(Other.Position, Pos) < MinDist * MinDist;
+            });
+        return bOverlaps;
+    }
+
+    void FCirclePacker::GetOverlapping(const FVec2& Pos, float Radius, std::vector<int32_t>& Out) const
+    {
+        const size_t First = Out.size();
+        const FVec2 Reach(Radius, Radius);
+        ForEachInBox(Pos - Reach, Pos + Reach, [&](int32_t Index)
+            {
+                // Tangent placements land within float error of their neighbours; that is touching, not overlapping.
+                const FCircle& Other = Circles[Index];
+                const float MinDist = (Radius + Other.TargetRadius) * 0.9999f;
+                if (FVec2::DistSquared(Other.Position, Pos) < MinDist * MinDist)
+                    Out.push_back(Index);
+            });
+        std::sort(Out.begin() + First, Out.end());
+        Out.erase(std::unique(Out.begin() + First, Out.end()), Out.end());
+    }
+
+    float FCirclePacker::ComputeEmissive(const FCircle& Circle, float Age)
+    {
+        float Emissive = 0.f;
+        if (Circle.Radius < Circle.TargetRadius)
+        {
+            // Growing → ramp up
+            Emissive = Circle.Radius / Circle.TargetRadius * 0.6f;
+        }
+        else
+        {
+            // Fully grown → fade over 5 seconds
+            Emissive = (1.f - (Age - (Circle.TargetRadius / Circle.GrowthRate)) / 5.f) * 0.6f;
+        }
+        return std::min(std::max(Emissive, 0.f), 0.6f);
+    }
+}
+
+namespace GenCore
+{
+    namespace
+    {
+        // Squared distance transform of one row or column (Felzenszwalb & Huttenlocher): Out[q] = min_p (q - p)² + In[p].
+        void DistanceTransform1D(const float* In, float* Out, int32_t Count, std::vector<int32_t>& Hull, std::vector<float>& Bounds)
+        {
+            Hull.resize(Count);
+            Bounds.resize(Count + 1);
+            int32_t K = 0;
+            Hull[0] = 0;
+            Bounds[0] = -std::numeric_limits<float>::infinity();
+            Bounds[1] = std::numeric_limits<float>::infinity();
+            auto Intersect = [In](int32_t Q, int32_t P)
+                {
+                    return ((In[Q] + static_cast<float>(Q) * Q) - (In[P] + static_cast<float>(P) * P)) / (2.f * (Q - P));
+                };
+            for (int32_t Q = 1; Q < Count; ++Q)
+            {
+                // Bounds[0] is -inf, so this stops at the first parabola
+                float S = Intersect(Q, Hull[K]);
+                while (S <= Bounds[K])
+                {
+                    --K;
+                    S = Intersect(Q, Hull[K]);
+                }
+                ++K;
+                Hull[K] = Q;
+                Bounds[K] = S;
+                Bounds[K + 1] = std::numeric_limits<float>::infinity();
+            }
+
+            K = 0;
+            for (int32_t Q = 0; Q < Count; ++Q)
+            {
+                while (Bounds[K + 1] < static_cast<float>(Q))
+                    ++K;
+                const float D = static_cast<float>(Q - Hull[K]);
+                Out[Q] = D * D + In[Hull[K]];
+            }
+        }
+    }
+
+    void FCirclePackingMask::Build(const std::vector<float>& InWeights, int32_t InWidth, int32_t InHeight)
+    {
+        Width = std::max(InWidth, 0);
+        Height = std::max(InHeight, 0);
+        Weights.assign(static_cast<size_t>(Width) * Height, 0.f);
+        for (size_t i = 0; i < Weights.size() && i < InWeights.size(); ++i)
+        {
+            Weights[i] = std::min(std::max(InWeights[i], 0.f), 1.f);
+        }
+
+        // Sum pyramid over a zero-padded power-of-two square
+        Dim = 1;
+        while (Dim < std::max(Width, Height))
+            Dim *= 2;
+        Pyramid.clear();
+        Pyramid.emplace_back(static_cast<size_t>(Dim) * Dim, 0.f);
+        for (int32_t Y = 0; Y < Height; ++Y)
+        {
+            for (int32_t X = 0; X < Width; ++X)
+            {
+                Pyramid[0][static_cast<size_t>(Y) * Dim + X] = Weights[static_cast<size_t>(Y) * Width + X];
+            }
+        }
+        for (int32_t Size = Dim / 2; Size >= 1; Size /= 2)
+        {
+            const std::vector<float>& Below = Pyramid.back();
+            std::vector<float> Level(static_cast<size_t>(Size) * Size);
+            for (int32_t Y = 0; Y < Size; ++Y)
+            {
+                for (int32_t X = 0; X < Size; ++X)
+                {
+                    const size_t B = static_cast<size_t>(2 * Y) * (2 * Size) + 2 * X;
+                    Level[static_cast<size_t>(Y) * Size + X] = Below[B] + Below[B + 1] + Below[B + 2 * Size] + Below[B + 2 * Size + 1];
+                }
+            }
+            Pyramid.push_back(std::move(Level));
+        }
+
+        // Distance to the nearest outside texel, with a one texel outside border around the image
+        const int32_t PadW = Width + 2;
+        const int32_t PadH = Height + 2;
+        const float Far = static_cast<float>(PadW) * PadW + static_cast<float>(PadH) * PadH;
+        std::vector<float> Field(static_cast<size_t>(PadW) * PadH, 0.f);
+        for (int32_t Y = 0; Y < Height; ++Y)
+        {
+            for (int32_t X = 0; X < Width; ++X)
+            {
+                Field[static_cast<size_t>(Y + 1) * PadW + X + 1] = Weights[static_cast<size_t>(Y) * Width + X] > 0.f ? Far : 0.f;
+            }
+        }
+
+        std::vector<float> In(std::max(PadW, PadH));
+        std::vector<float> Out(std::max(PadW, PadH));
+        std::vector<int32_t> Hull;
+        std::vector<float> Bounds;
+        for (int32_t X = 0; X < PadW; ++X)
+        {
+            for (int32_t Y = 0; Y < PadH; ++Y)
+                In[Y] = Field[static_cast<size_t>(Y) * PadW + X];
+            DistanceTransform1D(In.data(), Out.data(), PadH, Hull, Bounds);
+            for (int32_t Y = 0; Y < PadH; ++Y)
+                Field[static_cast<size_t>(Y) * PadW + X] = Out[Y];
+        }
+        for (int32_t Y = 0; Y < PadH; ++Y)
+        {
+            float* Row = &Field[static_cast<size_t>(Y) * PadW];
+            std::copy(Row, Row + PadW, In.begin());
+            DistanceTransform1D(In.data(), Row, PadW, Hull, Bounds);
+        }
+
+        // From a texel center to the nearest point of any outside texel: center-to-center distance less half a diagonal
+        EdgeDistance.assign(Weights.size(), 0.f);
+        for (int32_t Y = 0; Y < Height; ++Y)
+        {
+            for (int32_t X = 0; X < Width; ++X)
+            {
+                const float Squared = Field[static_cast<size_t>(Y + 1) * PadW + X + 1];
+                EdgeDistance[static_cast<size_t>(Y) * Width + X] = Squared > 0.f ? std::sqrt(Squared) - 0.70710678f : 0.f;
+            }
+        }
+    }
+
+    bool FCirclePackingMask::Sample(FGenRandom& Random, FVec2& OutTexel) const
+    {
+        if (IsEmpty())
+            return false;
+
+        // Down the pyramid: pick one of the four children in proportion to its sum
+        int32_t X = 0;
+        int32_t Y = 0;
+        for (int32_t Level = static_cast<int32_t>(Pyramid.size()) - 2; Level >= 0; --Level)
+        {
+            const std::vector<float>& Sums = Pyramid[Level];
+            const int32_t Size = Dim >> Level;
+            X *= 2;
+            Y *= 2;
+            const size_t B = static_cast<size_t>(Y) * Size + X;
+            const float Children[4] = { Sums[B], Sums[B + 1], Sums[B + Size], Sums[B + Size + 1] };
+            float Pick = Random.FRand() * (Children[0] + Children[1] + Children[2] + Children[3]);
+            // Round-off can leave Pick past every sum; it then falls to the last non-empty child, never to the
+            // zero padding beyond the image.
+            int32_t Child = -1;
+            for (int32_t Candidate = 0; Candidate < 4; ++Candidate)
+            {
+                if (Children[Candidate] <= 0.f)
+                    continue;
+                Child = Candidate;
+                if (Pick < Children[Candidate])
+                    break;
+                Pick -= Children[Candidate];
+            }
+            if (Child < 0)
+                return false;
+            X += Child & 1;
+            Y += Child >> 1;
+        }
+
+        if (X >= Width || Y >= Height)
+            return false;
+
+        // Jitter inside the texel, less in texels close to the edge so a circle still fits around the point
+        const float Jitter = std::min(EdgeDistance[static_cast<size_t>(Y) * Width + X], 1.f);
+        OutTexel = FVec2(X + 0.5f + (Random.FRand() - 0.5f) * Jitter, Y + 0.5f + (Random.FRand() - 0.5f) * Jitter);
+        // Float round-off can still end on an empty texel
+        return GetWeight(OutTexel) > 0.f;
+    }
+
+    int32_t FCirclePackingMask::TexelIndex(const FVec2& Texel) const
+    {
+        const int32_t X = static_cast<int32_t>(std::floor(Texel.X));
+        const int32_t Y = static_cast<int32_t>(std::floor(Texel.Y));
+        if (X < 0 || Y < 0 || X >= Width || Y >= Height)
+            return -1;
+        return Y * Width + X;
+    }
+
+    float FCirclePackingMask::GetWeight(const FVec2& Texel) const
+    {
+        const int32_t Index = TexelIndex(Texel);
+        return Index >= 0 ? Weights[Index] : 0.f;
+    }
+
+    float FCirclePackingMask::GetEdgeDistance(const FVec2& Texel) const
+    {
+        const int32_t Index = TexelIndex(Texel);
+        if (Index < 0)
+            return 0.f;
+        const FVec2 Center(std::floor(Texel.X) + 0.5f, std::floor(Texel.Y) + 0.5f);
+        return std::max(EdgeDistance[Index] - FVec2::Distance(Texel, Center), 0.f);
+    }
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "GenCoreTypes.h"
+#include "GenRandom.h"
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace GenCore
+{
+    struct FCircle
+    {
+        FVec2 Position;
+        float Radius = 0.f;
+        float TargetRadius = 50.f;
+        float GrowthRate = 20.f;
+
+        int32_t ID = -1;
+        // Packer clock when the circle spawned; its age is derived (FCirclePacker::GetAge), so aging costs nothing
+        float SpawnTime = 0.f;
+        FColor3 Color;
+    };
+
+    enum class ECirclePackingMode : uint8_t
+    {
+        // Darts at random positions; the first that fits is kept
+        Random,
+        // Every circle is placed tangent to two circles of the advancing front chain
+        FrontChain,
+        // Random darts against the current discs; circles grow until they touch a neighbour, then stop
+        GrowUntilContact,
+    };
+
+    // Shape and brightness input for packing, e.g. a logo or text. Built once from a weight image; then read-only, so one
+    // mask can be shared by several packers.
+    // - A sum pyramid (power-of-two, zero padded) draws points proportional to weight by descending from the 1x1 top,
+    //   so every draw lands inside the mask however thin or sparse it is.
+    // - An exact Euclidean distance transform gives every texel its distance to the nearest outside texel, which bounds
+    //   the largest disc that fits around any point.
+    class FCirclePackingMask
+    {
+    public:
+        // Weights row-major, Width x Height, in [0, 1]; <= 0 is outside the mask.
+        void Build(const std::vector<float>& Weights, int32_t Width, int32_t Height);
+
+        bool IsEmpty() const { return Pyramid.empty() || Pyramid.back()[0] <= 0.f; }
+        int32_t GetWidth() const { return Width; }
+        int32_t GetHeight() const { return Height; }
+
+        // A point in texel space ([0, Width) x [0, Height)), drawn proportional to weight. False if the mask is empty.
+        bool Sample(FGenRandom& Random, FVec2& OutTexel) const;
+
+        // At a texel-space point; 0 outside the image
+        float GetWeight(const FVec2& Texel) const;
+        // Radius of a disc around the point that stays inside the mask, in texels (0 outside the mask). Conservative:
+        // it clears whole outside texels.
+        float GetEdgeDistance(const FVec2& Texel) const;
+
+    private:
+        int32_t TexelIndex(const FVec2& Texel) const;
+
+        int32_t Width = 0;
+        int32_t Height = 0;
+        std::vector<float> Weights;
+        std::vector<float> EdgeDistance;
+        // Level L is (Dim >> L)² sums of the weights below; the last level is the 1x1 total.
+        std::vector<std::vector<float>> Pyramid;
+        int32_t Dim = 0;
+    };
+
+    struct FCirclePackingParams
+    {
+        ECirclePackingMode Mode = ECirclePackingMode::Random;
+        // Optional (Random and GrowUntilContact): darts are drawn from the mask instead of the whole canvas. The image
+        // spans the canvas along its longer side, U along +X, V along +Y. A circle's target radius is scaled by the
+        // mask weight there and capped by the distance to the mask edge, so it stays inside the shape.
+        std::shared_ptr<const FCirclePackingMask> Mask;
+        // Circles are placed in [-CanvasSize, CanvasSize] on both axes.
+        float CanvasSize = 1500.f;
+        float MinTargetRadius = 1.f;
+        float MaxTargetRadius = 300.f;
+        // Lower = more tiny, rarer big
+        float ExponentBias = 0.01f;
+        float GrowthRate = 20.f;
+        int32_t MaxAttempts = 500;
+    };
+
+    // Circle packing over reserved (target sized) discs, with two engines:
+    // - Random: every spawn attempt throws darts at the canvas and keeps the first one that does not touch any disc.
+    // - FrontChain (Wang et al., "Visualization of large hierarchical data by circle packing"): circles grow outward from
+    //   the canvas center. Each new circle is tangent to the front circle closest to the center and its successor on the
+    //   front chain; circles it would overlap are cut from the front and the placement retried. The front is a linked
+    //   list with a heap of distances, overlaps come from a grid, so a full canvas costs O(N log N).
+    //   Placement is deterministic; the seed only drives the radii and colors.
+    // - GrowUntilContact: nothing is reserved. A dart only has to clear the current discs by MinTargetRadius, and circles
+    //   grow until they reach their target or touch a neighbour, which then becomes their target. Only the growing set
+    //   is tested each step, against the grid, where a circle's footprint shrinks from its target to its final size.
+    class FCirclePacker
+    {
+    public:
+        void Reset(const FCirclePackingParams& InParams, uint64_t Seed);
+
+        // Returns the index of the new circle, or -1 if all attempts overlapped (FrontChain: the canvas is full).
+        int32_t TrySpawnNewCircle();
+
+        // Appends an already placed circle (e.g. from a snapshot) without an overlap test. Returns its index.
+        int32_t AddCircle(const FCircle& Circle);
+
+        // Moves the clock on by StepTime seconds and grows the circles toward their target size (GrowUntilContact: only
+        // the ones still growing).
+        void Advance(float StepTime);
+
+        // Seconds of Advance since the circle spawned
+        float GetAge(const FCircle& Circle) const { return Clock - Circle.SpawnTime; }
+        float GetClock() const { return Clock; }
+
+        // Circles still growing in GrowUntilContact mode
+        int32_t GetGrowingCount() const { return static_cast<int32_t>(Growing.size()); }
+        // Circles that touched a neighbour during the last Advance (GrowUntilContact); their TargetRadius is now final
+        const std::vector<int32_t>& GetSettled() const { return Settled; }
+
+        bool IsOverlapping(const FVec2& Pos, float Radius) const;
+        // Appends the indices of every circle whose disc overlaps (Pos, Radius); touching does not count.
+        void GetOverlapping(const FVec2& Pos, float Radius, std::vector<int32_t>& Out) const;
+
+        // Glow ramp: brightens while growing, fades out over 5 seconds once fully grown.
+        static float ComputeEmissive(const FCircle& Circle, float Age);
+
+        const std::vector<FCircle>& GetCircles() const { return Circles; }
+        const FCirclePackingParams& GetParams() const { return Params; }
+
+    private:
+        float SampleTargetRadius();
+        int32_t TrySpawnRandom();
+        int32_t TrySpawnFrontChain();
+        int32_t TrySpawnGrowing();
+        // A dart position and its target radius: over the canvas, or from the mask when there is one
+        bool ThrowDart(FVec2& OutPos, float& OutTargetRadius);
+        void AdvanceGrowing(float StepTime);
+        // Adds a new circle (color from the random stream) and indexes it
+        int32_t PushCircle(const FVec2& Pos, float TargetRadius);
+
+        int64_t CellKey(int32_t CellX, int32_t CellY) const
+        {
+            return (static_cast<int64_t>(CellX) << 32) ^ static_cast<int64_t>(static_cast<uint32_t>(CellY));
+        }
+        int32_t ToCell(float Coord) const { return static_cast<int32_t>(std::floor(Coord / CellSize)); }
+        // Calls Visit(CircleIndex) for every circle listed in the cells overlapping the box; a circle may come up more than once
+        // Lists the circle in (or removes it from) every cell overlapping its disc grown to Extent
+        void LinkCells(int32_t Index, float Extent);
+        void UnlinkCells(int32_t Index, float Extent);
+        template <typename VisitorType>
+        void ForEachInBox(const FVec2& Min, const FVec2& Max, VisitorType&& Visit) const;
+
+        // Front chain
+        void AddToFront(int32_t Index, int32_t Prev, int32_t Next);
+        void CutFront(int32_t From, int32_t To);
+
+        FCirclePackingParams Params;
+        FGenRandom Random;
+        std::vector<FCircle> Circles;
+        float Clock = 0.f;
+
+        // Cell → circles whose reserved disc (GrowUntilContact: the largest it can still become) overlaps the cell.
+        // Cells are about the mean target diameter.
+        float CellSize = 1.f;
+        std::unordered_map<int64_t, std::vector<int32_t>> Grid;
+
+        enum class EFrontState : uint8_t { Off, On, Closed };
+        // Circular, counter-clockwise; closed circles stay linked but have no room left inside the canvas
+        std::vector<int32_t> FrontNext;
+        std::vector<int32_t> FrontPrev;
+        std::vector<EFrontState> FrontState;
+        int32_t FrontLength = 0;
+        // (distance to the canvas center, circle), nearest on top; stale entries are skipped
+        std::priority_queue<std::pair<float, int32_t>, std::vector<std::pair<float, int32_t>>, std::greater<std::pair<float, int32_t>>> FrontQueue;
+        // GrowUntilContact: circles still growing, in spawn order
+        std::vector<int32_t> Growing;
+        std::vector<int32_t> Settled;
+
+        // Scratch
+        std::vector<int32_t> OverlapScratch;
+        std::vector<uint32_t> OverlapMark;
+        uint32_t OverlapPass = 0;
+    };
+}
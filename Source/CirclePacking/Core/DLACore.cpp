@@ -0,0 +1,226 @@
+#include "DLACore.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace GenCore
+{
+    namespace
+    {
+        // Walkers stepped together; the per-lane loops below have no branches so they vectorize.
+        constexpr int32_t WalkerLanes = 16;
+        // Walkers per ParallelFor work item (a whole number of lane blocks).
+        constexpr int32_t WalkerChunkSize = 64 * WalkerLanes;
+
+        // xorshift32: a single 32-bit state per walker, all shifts and xors, so a block of lanes advances in SIMD registers.
+        inline uint32_t NextLane(uint32_t& State)
+        {
+            State ^= State << 13;
+            State ^= State >> 17;
+            State ^= State << 5;
+            return State;
+        }
+
+        // Uniform in [0, Span)
+        inline int32_t LaneRange(uint32_t& State, int32_t Span)
+        {
+            return static_cast<int32_t>((static_cast<uint64_t>(NextLane(State)) * static_cast<uint64_t>(Span)) >> 32);
+        }
+    }
+
+    void FDLASimulation::Reset(const FDLAParams& InParams, uint64_t Seed)
+    {
+        Params = InParams;
+        Params.Bounds = std::min(std::max(Params.Bounds, 1), MaxDLABounds);
+        StepCount = 0;
+
+        Aggregate.clear();
+        AggregateOrder.clear();
+        NearOffset = Params.Bounds + 1;
+        NearDim = 2 * Params.Bounds + 3;
+        const size_t NearCells = static_cast<size_t>(NearDim) * NearDim * NearDim;
+        Near.assign((NearCells + 63) / 64, 0);
+
+        // One cube starts in the center — this is the seed.
+        AddToAggregate(FInt3(0, 0, 0));
+
+        const int32_t NumWalkers = std::max(Params.MaxWalkers, 0);
+        WalkerX.resize(NumWalkers);
+        WalkerY.resize(NumWalkers);
+        WalkerZ.resize(NumWalkers);
+        WalkerRandom.resize(NumWalkers);
+        for (int32_t i = 0; i < NumWalkers; ++i)
+        {
+            // Per-walker streams: the walk does not depend on how walkers are split across threads.
+            WalkerRandom[i] = static_cast<uint32_t>(MixSeed(Seed, 0xD1A, static_cast<uint64_t>(i))) | 1u;
+            SpawnWalkerOnEdge(i);
+        }
+    }
+
+    void FDLASimulation::AddToAggregate(const FInt3& Pos)
+    {
+        if (Aggregate.insert(PackKey(Pos)).second)
+        {
+            AggregateOrder.push_back(Pos);
+
+            // Mark the voxel and its 26 neighbours (clipped to the grid) as sticking cells.
+            const int32_t Limit = Params.Bounds + 1;
+            for (int32_t X = std::max(Pos.X - 1, -Limit); X <= std::min(Pos.X + 1, Limit); ++X)
+            {
+                for (int32_t Y = std::max(Pos.Y - 1, -Limit); Y <= std::min(Pos.Y + 1, Limit); ++Y)
+                {
+                    for (int32_t Z = std::max(Pos.Z - 1, -Limit); Z <= std::min(Pos.Z + 1, Limit); ++Z)
+                    {
+                        const size_t Index = NearIndex(X, Y, Z);
+                        Near[Index >> 6] |= 1ull << (Index & 63);
+                    }
+                }
+            }
+        }
+    }
+
+    void FDLASimulation::SpawnWalkerOnEdge(int32_t Index)
+    {
+        // Same as GetRandomEdgePosition, drawn from the walker's own stream.
+        uint32_t& State = WalkerRandom[Index];
+        const int32_t Bounds = Params.Bounds;
+        const int32_t Axis = LaneRange(State, 3);
+        const int32_t Side = LaneRange(State, 2) != 0 ? Bounds : -Bounds;
+        int16_t* Coords[3] = { &WalkerX[Index], &WalkerY[Index], &WalkerZ[Index] };
+        for (int32_t i = 0; i < 3; ++i)
+        {
+            *Coords[i] = static_cast<int16_t>(i == Axis ? Side : LaneRange(State, 2 * Bounds + 1) - Bounds);
+        }
+    }
+
+    std::vector<FInt3> FDLASimulation::GetWalkers() const
+    {
+        std::vector<FInt3> Out;
+        Out.reserve(WalkerX.size());
+        for (int32_t i = 0; i < GetWalkerCount(); ++i)
+        {
+            Out.push_back(GetWalker(i));
+        }
+        return Out;
+    }
+
+    void FDLASimulation::Step(const FParallelForFn& ParallelFor, std::vector<FInt3>& OutStuck)
+    {
+        // Gradually reduce the number of active walkers over time to simulate slowing coral growth.
+        // No new walkers are added anymore, the pool just shrinks as the sim matures.
+        ++StepCount;
+        const int32_t TargetWalkerCount = std::max(Params.MinWalkers, Params.MaxWalkers - StepCount / std::max(1, Params.StepsPerWalkerDecay));
+        if (GetWalkerCount() > TargetWalkerCount)
+        {
+            WalkerX.resize(TargetWalkerCount);
+            WalkerY.resize(TargetWalkerCount);
+            WalkerZ.resize(TargetWalkerCount);
+            WalkerRandom.resize(TargetWalkerCount);
+        }
+
+        const int32_t NumWalkers = GetWalkerCount();
+        const int32_t NumChunks = (NumWalkers + WalkerChunkSize - 1) / WalkerChunkSize;
+        ChunkStuck.resize(NumChunks);
+
+        // The aggregate is only read during the walk; everything that sticks is applied afterwards.
+        ParallelFor(NumChunks, [this, NumWalkers](int32_t Chunk)
+            {
+                std::vector<FInt3>& Stuck = ChunkStuck[Chunk];
+                Stuck.clear();
+
+                int16_t* X = WalkerX.data();
+                int16_t* Y = WalkerY.data();
+                int16_t* Z = WalkerZ.data();
+                uint32_t* Rng = WalkerRandom.data();
+                // |C| > Bounds as one unsigned compare
+                const uint32_t Span = static_cast<uint32_t>(2 * Params.Bounds);
+                const int32_t Bounds = Params.Bounds;
+
+                const int32_t End = std::min((Chunk + 1) * WalkerChunkSize, NumWalkers);
+                for (int32_t Block = Chunk * WalkerChunkSize; Block < End; Block += WalkerLanes)
+                {
+                    const int32_t Lanes = std::min(WalkerLanes, End - Block);
+                    uint8_t Respawn[WalkerLanes];
+
+                    // --- Pure 3D Random Walk (Brownian Motion) ---
+                    // One draw per lane, decoded into a step of -1, 0 or +1 on each axis.
+                    for (int32_t L = 0; L < Lanes; ++L)
+                    {
+                        const int32_t i = Block + L;
+                        const FInt3 Move = DecodeWalkerStep(NextLane(Rng[i]));
+                        X[i] = static_cast<int16_t>(X[i] + Move.X);
+                        Y[i] = static_cast<int16_t>(Y[i] + Move.Y);
+                        Z[i] = static_cast<int16_t>(Z[i] + Move.Z);
+                        Respawn[L] = static_cast<uint8_t>((static_cast<uint32_t>(X[i] + Bounds) > Span)
+                            | (static_cast<uint32_t>(Y[i] + Bounds) > Span)
+                            | (static_cast<uint32_t>(Z[i] + Bounds) > Span));
+                    }
+
+                    // A walker is at most one cell outside the bounds here, still inside the occupancy grid.
+                    uint8_t Hit[WalkerLanes];
+                    for (int32_t L = 0; L < Lanes; ++L)
+                    {
+                        Hit[L] = static_cast<uint8_t>(IsNear(X[Block + L], Y[Block + L], Z[Block + L]));
+                    }
+
+                    // Sticking and leaving are rare, so only these lanes take the scalar path.
+                    for (int32_t L = 0; L < Lanes; ++L)
+                    {
+                        if ((Hit[L] | Respawn[L]) == 0)
+                            continue;
+
+                        // Record for aggregation and respawn at the edge to keep the walker count
+                        if (Hit[L])
+                            Stuck.push_back(GetWalker(Block + L));
+                        SpawnWalkerOnEdge(Block + L);
+                    }
+                }
+            });
+
+        // Apply in chunk order so a given seed always grows the same cluster.
+        for (const std::vector<FInt3>& Stuck : ChunkStuck)
+        {
+            for (const FInt3& Pos : Stuck)
+            {
+                const size_t Before = AggregateOrder.size();
+                AddToAggregate(Pos);
+                if (AggregateOrder.size() != Before)
+                {
+                    OutStuck.push_back(Pos);
+                }
+            }
+        }
+    }
+
+    bool FDLASimulation::IsAdjacentToAggregate(const FInt3& Pos) const
+    {
+        // All 26 neighbouring positions in the 3x3x3 cube around the voxel.
+        for (int32_t X = -1; X <= 1; ++X)
+        {
+            for (int32_t Y = -1; Y <= 1; ++Y)
+            {
+                for (int32_t Z = -1; Z <= 1; ++Z)
+                {
+                    if (X == 0 && Y == 0 && Z == 0)
+                        continue; // Skip self
+
+                    if (Aggregate.count(PackKey(Pos + FInt3(X, Y, Z))) != 0)
+                        return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    FInt3 FDLASimulation::GetRandomEdgePosition(FGenRandom& Rng) const
+    {
+        // Set the chosen axis to the edge (+Bounds or -Bounds), randomize the other two.
+        FInt3 Pos;
+        const int32_t Axis = Rng.RandRange(0, 2);
+        const int32_t Side = Rng.RandBool() ? Params.Bounds : -Params.Bounds;
+        for (int32_t i = 0; i < 3; ++i)
+        {
+            Pos[i] = (i == Axis) ? Side : Rng.RandRange(-Params.Bounds, Params.Bounds);
+        }
+        return Pos;
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "GenCoreTypes.h"
+#include "GenRandom.h"
+#include <unordered_set>
+#include <vector>
+
+namespace GenCore
+{
+    struct FDLAParams
+    {
+        int32_t MaxWalkers = 200;
+        // Walkers live in [-Bounds, Bounds] on every axis. Capped at MaxDLABounds: coordinates are stored as int16
+        // and the occupancy grid is dense, (2·Bounds+3)³ bits: about 1 MB at Bounds 100, 17 MB at 256 and 135 MB at
+        // the cap (see GetDLANearGridBytes).
+        int32_t Bounds = 50;
+        // The walker pool shrinks by one every StepsPerWalkerDecay steps, down to MinWalkers.
+        int32_t MinWalkers = 5;
+        int32_t StepsPerWalkerDecay = 90;
+    };
+
+    constexpr int32_t MaxDLABounds = 512;
+    // Above this the occupancy grid passes 16 MB
+    constexpr int32_t LargeDLABounds = 256;
+
+    // Memory taken by the dense occupancy grid for a bound (clamped as Reset does)
+    inline size_t GetDLANearGridBytes(int32_t Bounds)
+    {
+        const size_t Dim = 2 * static_cast<size_t>(Bounds < 1 ? 1 : (Bounds > MaxDLABounds ? MaxDLABounds : Bounds)) + 3;
+        return (Dim * Dim * Dim + 63) / 64 * sizeof(uint64_t);
+    }
+
+    // One walker move from one 32-bit draw: the three base-3 digits of Draw % 27 give -1, 0 or +1 per axis, so all
+    // 27 moves are equally likely and the walk has no drift.
+    inline FInt3 DecodeWalkerStep(uint32_t Draw)
+    {
+        const int32_t Move = static_cast<int32_t>(Draw % 27u);
+        return FInt3(Move % 3 - 1, (Move / 3) % 3 - 1, Move / 9 - 1);
+    }
+
+    // 3D diffusion-limited aggregation on an integer lattice.
+    // Walkers random-walk until they touch the aggregate (26-neighbourhood), then stick.
+    // Walkers are stored as int16 coordinate arrays (SoA) with one random stream per walker, and stepped in blocks
+    // of 16 lanes with branch-free moves and bounds tests, so the compiler can vectorize the block loops.
+    class FDLASimulation
+    {
+    public:
+        // Seeds the aggregate with the origin and spawns MaxWalkers walkers on the bounds.
+        void Reset(const FDLAParams& InParams, uint64_t Seed);
+
+        // Moves every walker one step. Voxels that stuck this step are appended to OutStuck
+        // in stick order (the seed is reported by Reset via GetAggregateOrder()).
+        void Step(const FParallelForFn& ParallelFor, std::vector<FInt3>& OutStuck);
+
+        bool IsAdjacentToAggregate(const FInt3& Pos) const;
+        bool IsInAggregate(const FInt3& Pos) const { return Aggregate.count(PackKey(Pos)) != 0; }
+
+        FInt3 GetRandomEdgePosition(FGenRandom& Rng) const;
+
+        int32_t GetWalkerCount() const { return static_cast<int32_t>(WalkerX.size()); }
+        FInt3 GetWalker(int32_t Index) const { return FInt3(WalkerX[Index], WalkerY[Index], WalkerZ[Index]); }
+        // Copy of all walker positions (debugging, tests)
+        std::vector<FInt3> GetWalkers() const;
+        // Every aggregated voxel in the order it stuck; index 0 is the seed.
+        const std::vector<FInt3>& GetAggregateOrder() const { return AggregateOrder; }
+        int32_t GetStepCount() const { return StepCount; }
+        const FDLAParams& GetParams() const { return Params; }
+
+    private:
+        static uint64_t PackKey(const FInt3& Pos)
+        {
+            // 21 bits per axis, biased so negative coordinates pack cleanly.
+            const uint64_t Bias = 1u << 20;
+            return ((static_cast<uint64_t>(Pos.X + Bias) & 0x1FFFFF) << 42)
+                | ((static_cast<uint64_t>(Pos.Y + Bias) & 0x1FFFFF) << 21)
+                | (static_cast<uint64_t>(Pos.Z + Bias) & 0x1FFFFF);
+        }
+
+        void AddToAggregate(const FInt3& Pos);
+        void SpawnWalkerOnEdge(int32_t Index);
+
+        // Bit per lattice cell over [-Bounds-1, Bounds+1]³: set where a cell is in or next to the aggregate.
+        size_t NearIndex(int32_t X, int32_t Y, int32_t Z) const
+        {
+            return (static_cast<size_t>(X + NearOffset) * NearDim + static_cast<size_t>(Y + NearOffset)) * NearDim + static_cast<size_t>(Z + NearOffset);
+        }
+        bool IsNear(int32_t X, int32_t Y, int32_t Z) const
+        {
+            const size_t Index = NearIndex(X, Y, Z);
+            return (Near[Index >> 6] >> (Index & 63)) & 1u;
+        }
+
+        FDLAParams Params;
+        int32_t StepCount = 0;
+
+        // Walker i is (WalkerX[i], WalkerY[i], WalkerZ[i]); WalkerRandom[i] is its xorshift32 state.
+        std::vector<int16_t> WalkerX;
+        std::vector<int16_t> WalkerY;
+        std::vector<int16_t> WalkerZ;
+        std::vector<uint32_t> WalkerRandom;
+
+        std::unordered_set<uint64_t> Aggregate;
+        std::vector<FInt3> AggregateOrder;
+        std::vector<uint64_t> Near;
+        int32_t NearOffset = 0;
+        int32_t NearDim = 0;
+
+        // Per-chunk scratch so the parallel walk needs no locks.
+        std::vector<std::vector<FInt3>> ChunkStuck;
+    };
+}
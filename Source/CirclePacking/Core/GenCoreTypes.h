@@ -0,0 +1,113 @@
+#pragma once
+
+// Engine-independent building blocks shared by the generator cores.
+// Nothing in Core/ may include engine headers: the same sources are compiled
+// into the game module and into the native test/benchmark harness (Tests/GeneratorCore).
+
+#include <cstdint>
+#include <cmath>
+#include <functional>
+
+namespace GenCore
+{
+    constexpr float GenPi = 3.14159265358979323846f;
+
+    struct FVec2
+    {
+        float X = 0.f;
+        float Y = 0.f;
+
+        FVec2() = default;
+        FVec2(float InX, float InY) : X(InX), Y(InY) {}
+
+        FVec2 operator+(const FVec2& Other) const { return FVec2(X + Other.X, Y + Other.Y); }
+        FVec2 operator-(const FVec2& Other) const { return FVec2(X - Other.X, Y - Other.Y); }
+        FVec2 operator*(float Scale) const { return FVec2(X * Scale, Y * Scale); }
+
+        static float DistSquared(const FVec2& A, const FVec2& B)
+        {
+            const float DX = A.X - B.X;
+            const float DY = A.Y - B.Y;
+            return DX * DX + DY * DY;
+        }
+
+        static float Distance(const FVec2& A, const FVec2& B) { return std::sqrt(DistSquared(A, B)); }
+    };
+
+    struct FVec3
+    {
+        float X = 0.f;
+        float Y = 0.f;
+        float Z = 0.f;
+
+        FVec3() = default;
+        FVec3(float InX, float InY, float InZ) : X(InX), Y(InY), Z(InZ) {}
+
+        float& operator[](int32_t Axis) { return Axis == 0 ? X : (Axis == 1 ? Y : Z); }
+        float operator[](int32_t Axis) const { return Axis == 0 ? X : (Axis == 1 ? Y : Z); }
+
+        FVec3 operator+(const FVec3& Other) const { return FVec3(X + Other.X, Y + Other.Y, Z + Other.Z); }
+        FVec3 operator-(const FVec3& Other) const { return FVec3(X - Other.X, Y - Other.Y, Z - Other.Z); }
+
+        static FVec3 Cross(const FVec3& A, const FVec3& B)
+        {
+            return FVec3(A.Y * B.Z - A.Z * B.Y, A.Z * B.X - A.X * B.Z, A.X * B.Y - A.Y * B.X);
+        }
+        static float Dot(const FVec3& A, const FVec3& B) { return A.X * B.X + A.Y * B.Y + A.Z * B.Z; }
+    };
+
+    struct FInt3
+    {
+        int32_t X = 0;
+        int32_t Y = 0;
+        int32_t Z = 0;
+
+        FInt3() = default;
+        FInt3(int32_t InX, int32_t InY, int32_t InZ) : X(InX), Y(InY), Z(InZ) {}
+
+        int32_t& operator[](int32_t Axis) { return Axis == 0 ? X : (Axis == 1 ? Y : Z); }
+        int32_t operator[](int32_t Axis) const { return Axis == 0 ? X : (Axis == 1 ? Y : Z); }
+
+        FInt3 operator+(const FInt3& Other) const { return FInt3(X + Other.X, Y + Other.Y, Z + Other.Z); }
+        bool operator==(const FInt3& Other) const { return X == Other.X && Y == Other.Y && Z == Other.Z; }
+        bool operator!=(const FInt3& Other) const { return !(*this == Other); }
+    };
+
+    struct FColor3
+    {
+        float R = 1.f;
+        float G = 1.f;
+        float B = 1.f;
+
+        FColor3() = default;
+        FColor3(float InR, float InG, float InB) : R(InR), G(InG), B(InB) {}
+    };
+
+    // Fully saturated, full value colour for a hue in [0, 1).
+    inline FColor3 HueToRgb(float Hue)
+    {
+        const float H = (Hue - std::floor(Hue)) * 6.f;
+        const float X = 1.f - std::fabs(std::fmod(H, 2.f) - 1.f);
+        switch (static_cast<int32_t>(H))
+        {
+        case 0:  return FColor3(1.f, X, 0.f);
+        case 1:  return FColor3(X, 1.f, 0.f);
+        case 2:  return FColor3(0.f, 1.f, X);
+        case 3:  return FColor3(0.f, X, 1.f);
+        case 4:  return FColor3(X, 0.f, 1.f);
+        default: return FColor3(1.f, 0.f, X);
+        }
+    }
+
+    // Runs Body(i) for i in [0, Num). The engine adapters hand in a wrapper around ParallelFor,
+    // the native harness uses SerialFor or its own thread pool. Body must be safe to run concurrently.
+    using FParallelForFn = std::function<void(int32_t Num, const std::function<void(int32_t)>& Body)>;
+
+    inline void SerialFor(int32_t Num, const std::function<void(int32_t)>& Body)
+    {
+        for (int32_t i = 0; i < Num; ++i)
+        {
+            Body(i);
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "GenCoreTypes.h"
+
+namespace GenCore
+{
+    // Small seedable generator (xorshift64*) so the cores never touch FMath's global stream.
+    // One instance per thread; it is cheap enough to create per ParallelFor chunk.
+    class FGenRandom
+    {
+    public:
+        explicit FGenRandom(uint64_t Seed = 0x9E3779B97F4A7C15ull)
+        {
+            Initialize(Seed);
+        }
+
+        void Initialize(uint64_t Seed)
+        {
+            // splitmix64 scramble so neighbouring seeds give unrelated streams
+            uint64_t Z = Seed + 0x9E3779B97F4A7C15ull;
+            Z = (Z ^ (Z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            Z = (Z ^ (Z >> 27)) * 0x94D049BB133111EBull;
+            State = (Z ^ (Z >> 31)) | 1ull;
+        }
+
+        uint32_t NextUInt32()
+        {
+            State ^= State >> 12;
+            State ^= State << 25;
+            State ^= State >> 27;
+            return static_cast<uint32_t>((State * 0x2545F4914F6CDD1Dull) >> 32);
+        }
+
+        // [0, 1)
+        float FRand()
+        {
+            return static_cast<float>(NextUInt32() >> 8) * (1.f / 16777216.f);
+        }
+
+        float FRandRange(float Min, float Max)
+        {
+            return Min + (Max - Min) * FRand();
+        }
+
+        // Inclusive on both ends, like FMath::RandRange.
+        int32_t RandRange(int32_t Min, int32_t Max)
+        {
+            const uint64_t Range = static_cast<uint64_t>(static_cast<int64_t>(Max) - Min + 1);
+            return Min + static_cast<int32_t>((static_cast<uint64_t>(NextUInt32()) * Range) >> 32);
+        }
+
+        bool RandBool()
+        {
+            return (NextUInt32() & 0x80000000u) != 0;
+        }
+
+    private:
+        uint64_t State = 1;
+    };
+
+    // Derives an independent seed for a sub-stream (per step, per chunk, ...).
+    inline uint64_t MixSeed(uint64_t Seed, uint64_t A, uint64_t B = 0)
+    {
+        uint64_t Z = Seed ^ (A * 0xD6E8FEB86659FD93ull) ^ (B * 0xA0761D6478BD642Full);
+        Z = (Z ^ (Z >> 32)) * 0xD6E8FEB86659FD93ull;
+        return Z ^ (Z >> 32);
+    }
+}
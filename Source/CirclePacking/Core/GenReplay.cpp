@@ -0,0 +1,237 @@
+#include "GenReplay.h"
+
+#include <algorithm>
+
+namespace GenCore
+{
+    namespace
+    {
+        constexpr uint8_t FlagNewFrame = 1 << 2;
+        constexpr uint8_t FlagSize = 1 << 3;
+        constexpr uint8_t FlagId = 1 << 4;
+        constexpr uint8_t FlagColor = 1 << 5;
+        constexpr uint8_t FlagRotation = 1 << 6;
+        constexpr uint8_t TypeMask = 0x3;
+    }
+
+    void FReplayWriter::Reset(float PositionStep, float RotationStep)
+    {
+        *this = FReplayWriter();
+        Header.PositionStep = PositionStep > 0.f ? PositionStep : 0.01f;
+        Header.RotationStep = RotationStep > 0.f ? RotationStep : 0.01f;
+    }
+
+    void FReplayWriter::WriteVarint(uint64_t Value)
+    {
+        while (Value >= 0x80)
+        {
+            Payload.push_back(static_cast<uint8_t>(Value | 0x80));
+            Value >>= 7;
+        }
+        Payload.push_back(static_cast<uint8_t>(Value));
+    }
+
+    void FReplayWriter::Add(const FReplayEvent& Event)
+    {
+        const int64_t Milliseconds = std::llround(Event.Time * 1000.0);
+        const int64_t Position[3] = {
+            Quantize(Event.Position.X, Header.PositionStep),
+            Quantize(Event.Position.Y, Header.PositionStep),
+            Quantize(Event.Position.Z, Header.PositionStep) };
+        const int64_t Size = Quantize(Event.Size, Header.PositionStep);
+        const int64_t Rotation[3] = {
+            Quantize(Event.Rotation.X, Header.RotationStep),
+            Quantize(Event.Rotation.Y, Header.RotationStep),
+            Quantize(Event.Rotation.Z, Header.RotationStep) };
+        const uint8_t Color[3] = { Event.R, Event.G, Event.B };
+
+        // Events arrive in frame order; a late one is filed under the current frame
+        const bool bNewFrame = Header.EventCount == 0 || Event.Frame > LastFrame;
+        const bool bRotation = Rotation[0] != LastRotation[0] || Rotation[1] != LastRotation[1] || Rotation[2] != LastRotation[2];
+        const bool bColor = Color[0] != LastColor[0] || Color[1] != LastColor[1] || Color[2] != LastColor[2];
+
+        uint8_t Flags = static_cast<uint8_t>(Event.Type) & TypeMask;
+        Flags |= bNewFrame ? FlagNewFrame : 0;
+        Flags |= Size != LastSize ? FlagSize : 0;
+        Flags |= Event.Id != LastId ? FlagId : 0;
+        Flags |= bColor ? FlagColor : 0;
+        Flags |= bRotation ? FlagRotation : 0;
+        Payload.push_back(Flags);
+
+        if (bNewFrame)
+        {
+            WriteVarint(Event.Frame - (Header.EventCount == 0 ? 0 : LastFrame));
+            WriteVarint(static_cast<uint64_t>(std::max<int64_t>(Milliseconds - LastMilliseconds, 0)));
+            LastFrame = Event.Frame;
+            LastMilliseconds = std::max(Milliseconds, LastMilliseconds);
+        }
+        for (int32_t Axis = 0; Axis < 3; ++Axis)
+        {
+            WriteSigned(Position[Axis] - LastPosition[Axis]);
+            LastPosition[Axis] = Position[Axis];
+        }
+        if (Flags & FlagSize)
+        {
+            WriteSigned(Size - LastSize);
+            LastSize = Size;
+        }
+        if (Flags & FlagId)
+        {
+            WriteSigned(static_cast<int64_t>(Event.Id) - LastId);
+            LastId = Event.Id;
+        }
+        if (bColor)
+        {
+            Payload.insert(Payload.end(), Color, Color + 3);
+            std::copy(Color, Color + 3, LastColor);
+        }
+        if (bRotation)
+        {
+            for (int32_t Axis = 0; Axis < 3; ++Axis)
+            {
+                WriteSigned(Rotation[Axis] - LastRotation[Axis]);
+                LastRotation[Axis] = Rotation[Axis];
+            }
+        }
+
+        ++Header.EventCount;
+        Header.LastFrame = LastFrame;
+    }
+
+    std::vector<uint8_t> FReplayWriter::Finalize() const
+    {
+        FReplayHeader Out = Header;
+        Out.PayloadSize = Payload.size();
+
+        std::vector<uint8_t> Image(sizeof(FReplayHeader) + Payload.size());
+        std::memcpy(Image.data(), &Out, sizeof(Out));
+        if (!Payload.empty())
+        {
+            std::memcpy(Image.data() + sizeof(Out), Payload.data(), Payload.size());
+        }
+        return Image;
+    }
+
+    ESnapshotError FReplayReader::Open(const uint8_t* Data, uint64_t Size)
+    {
+        *this = FReplayReader();
+        if (Size < sizeof(FReplayHeader)) return Error = ESnapshotError::TooSmall;
+
+        std::memcpy(&Header, Data, sizeof(Header));
+        if (Header.Magic != ReplayMagic) return Error = ESnapshotError::BadMagic;
+        if (Header.Version != ReplayVersion) return Error = ESnapshotError::UnsupportedVersion;
+        if (Header.HeaderSize < sizeof(FReplayHeader) || Header.HeaderSize > Size || Header.PayloadSize != Size - Header.HeaderSize
+            || !(Header.PositionStep > 0.f) || !(Header.RotationStep > 0.f))
+            return Error = ESnapshotError::Corrupt;
+
+        Cursor = Data + Header.HeaderSize;
+        End = Data + Size;
+        EventsLeft = Header.EventCount;
+        return ESnapshotError::None;
+    }
+
+    bool FReplayReader::ReadVarint(uint64_t& OutValue)
+    {
+        OutValue = 0;
+        for (int32_t Shift = 0; Shift < 64 && Cursor < End; Shift += 7)
+        {
+            const uint8_t Byte = *Cursor++;
+            OutValue |= static_cast<uint64_t>(Byte & 0x7F) << Shift;
+            if ((Byte & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool FReplayReader::ReadSigned(int64_t& OutValue)
+    {
+        uint64_t Raw = 0;
+        if (!ReadVarint(Raw))
+            return false;
+        OutValue = static_cast<int64_t>(Raw >> 1) ^ -static_cast<int64_t>(Raw & 1);
+        return true;
+    }
+
+    bool FReplayReader::Next(FReplayEvent& OutEvent)
+    {
+        if (EventsLeft == 0 || Error != ESnapshotError::None)
+            return false;
+
+        // Any read past the end means the stream was cut short
+        auto Fail = [this]()
+            {
+                Error = ESnapshotError::Corrupt;
+                EventsLeft = 0;
+                return false;
+            };
+        if (Cursor >= End)
+            return Fail();
+
+        const uint8_t Flags = *Cursor++;
+        if ((Flags & TypeMask) > static_cast<uint8_t>(EReplayEventType::Settle))
+            return Fail();
+
+        if (Flags & FlagNewFrame)
+        {
+            uint64_t FrameDelta = 0;
+            uint64_t MillisecondDelta = 0;
+            if (!ReadVarint(FrameDelta) || !ReadVarint(MillisecondDelta))
+                return Fail();
+            LastFrame += static_cast<uint32_t>(FrameDelta);
+            LastMilliseconds += static_cast<int64_t>(MillisecondDelta);
+        }
+        for (int32_t Axis = 0; Axis < 3; ++Axis)
+        {
+            int64_t Delta = 0;
+            if (!ReadSigned(Delta))
+                return Fail();
+            LastPosition[Axis] += Delta;
+        }
+        if (Flags & FlagSize)
+        {
+            int64_t Delta = 0;
+            if (!ReadSigned(Delta))
+                return Fail();
+            LastSize += Delta;
+        }
+        if (Flags & FlagId)
+        {
+            int64_t Delta = 0;
+            if (!ReadSigned(Delta))
+                return Fail();
+            LastId = static_cast<int32_t>(LastId + Delta);
+        }
+        if (Flags & FlagColor)
+        {
+            if (End - Cursor < 3)
+                return Fail();
+            std::copy(Cursor, Cursor + 3, LastColor);
+            Cursor += 3;
+        }
+        if (Flags & FlagRotation)
+        {
+            for (int32_t Axis = 0; Axis < 3; ++Axis)
+            {
+                int64_t Delta = 0;
+                if (!ReadSigned(Delta))
+                    return Fail();
+                LastRotation[Axis] += Delta;
+            }
+        }
+
+        const float Step = Header.PositionStep;
+        const float Degrees = Header.RotationStep;
+        OutEvent.Type = static_cast<EReplayEventType>(Flags & TypeMask);
+        OutEvent.Frame = LastFrame;
+        OutEvent.Time = static_cast<double>(LastMilliseconds) / 1000.0;
+        OutEvent.Position = FVec3(LastPosition[0] * Step, LastPosition[1] * Step, LastPosition[2] * Step);
+        OutEvent.Size = LastSize * Step;
+        OutEvent.Id = LastId;
+        OutEvent.Rotation = FVec3(LastRotation[0] * Degrees, LastRotation[1] * Degrees, LastRotation[2] * Degrees);
+        OutEvent.R = LastColor[0];
+        OutEvent.G = LastColor[1];
+        OutEvent.B = LastColor[2];
+        --EventsLeft;
+        return true;
+    }
+}
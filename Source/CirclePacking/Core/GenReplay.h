@@ -0,0 +1,133 @@
+#pragma once
+
+#include "GenCoreTypes.h"
+#include "GenSnapshot.h"
+#include <vector>
+
+// Compact log of generation events (a circle spawned, a voxel stuck, ...) for simulation-free playback.
+//
+//   [FReplayHeader][event stream]
+//
+// Events are stored as deltas against the previous event, as LEB128 varints (signed values zigzag encoded):
+//
+//   flags (1 byte): bits 0-1 type, 2 new frame, 3 size, 4 id, 5 colour, 6 rotation
+//   [new frame]  frame delta, time delta in milliseconds
+//   position     X, Y, Z deltas in PositionStep units
+//   [size]       delta in PositionStep units
+//   [id]         delta
+//   [colour]     R, G, B bytes
+//   [rotation]   pitch, yaw, roll deltas in RotationStep degrees
+//
+// Fields only appear when they differ from the previous event, so a voxel that sticks next to the last one
+// costs about four bytes. Little-endian only.
+namespace GenCore
+{
+    constexpr uint32_t ReplayMagic = 0x524E4547; // "GENR"
+    constexpr uint16_t ReplayVersion = 1;
+
+    enum class EReplayEventType : uint8_t
+    {
+        // A new element: circle, Poisson sample, prime
+        Spawn = 0,
+        // A DLA voxel joined the aggregate
+        Stick = 1,
+        // An earlier element's final size became known (Id = its spawn order, Size = the size)
+        Settle = 2,
+    };
+
+    struct FReplayEvent
+    {
+        EReplayEventType Type = EReplayEventType::Spawn;
+        // Generator frame, counted from the start of the recording
+        uint32_t Frame = 0;
+        // Seconds since the start of the recording (millisecond resolution)
+        double Time = 0.0;
+        FVec3 Position;
+        // Radius or scale, in position units
+        float Size = 0.f;
+        // Mesh index, prime index, ...
+        int32_t Id = 0;
+        // Pitch, yaw, roll in degrees
+        FVec3 Rotation;
+        uint8_t R = 255;
+        uint8_t G = 255;
+        uint8_t B = 255;
+    };
+
+    struct FReplayHeader
+    {
+        uint32_t Magic = ReplayMagic;
+        uint16_t Version = ReplayVersion;
+        uint16_t HeaderSize = sizeof(FReplayHeader);
+        uint32_t EventCount = 0;
+        uint32_t LastFrame = 0;
+        float PositionStep = 0.01f;
+        float RotationStep = 0.01f;
+        uint64_t PayloadSize = 0;
+    };
+    static_assert(sizeof(FReplayHeader) == 32, "Replay header layout changed");
+
+    // Appends events (in frame order) to an in-memory stream.
+    class FReplayWriter
+    {
+    public:
+        // Positions and sizes are rounded to PositionStep, rotations to RotationStep degrees.
+        void Reset(float PositionStep = 0.01f, float RotationStep = 0.01f);
+
+        void Add(const FReplayEvent& Event);
+
+        uint32_t GetEventCount() const { return Header.EventCount; }
+        uint64_t GetPayloadSize() const { return Payload.size(); }
+
+        // Header + stream. The writer keeps its events, so a recording can be saved more than once.
+        std::vector<uint8_t> Finalize() const;
+
+    private:
+        void WriteVarint(uint64_t Value);
+        void WriteSigned(int64_t Value) { WriteVarint((static_cast<uint64_t>(Value) << 1) ^ static_cast<uint64_t>(Value >> 63)); }
+        int64_t Quantize(float Value, float Step) const { return static_cast<int64_t>(std::llround(static_cast<double>(Value) / Step)); }
+
+        FReplayHeader Header;
+        std::vector<uint8_t> Payload;
+
+        // Previous event, quantized
+        uint32_t LastFrame = 0;
+        int64_t LastMilliseconds = 0;
+        int64_t LastPosition[3] = {};
+        int64_t LastSize = 0;
+        int32_t LastId = 0;
+        uint8_t LastColor[3] = { 255, 255, 255 };
+        int64_t LastRotation[3] = {};
+    };
+
+    // Decodes a stream one event at a time, straight from the file image (which must outlive the reader).
+    class FReplayReader
+    {
+    public:
+        ESnapshotError Open(const uint8_t* Data, uint64_t Size);
+
+        // False at the end of the stream, or if it is cut short (GetError() then says Corrupt).
+        bool Next(FReplayEvent& OutEvent);
+
+        const FReplayHeader& GetHeader() const { return Header; }
+        ESnapshotError GetError() const { return Error; }
+
+    private:
+        bool ReadVarint(uint64_t& OutValue);
+        bool ReadSigned(int64_t& OutValue);
+
+        FReplayHeader Header;
+        const uint8_t* Cursor = nullptr;
+        const uint8_t* End = nullptr;
+        uint32_t EventsLeft = 0;
+        ESnapshotError Error = ESnapshotError::None;
+
+        uint32_t LastFrame = 0;
+        int64_t LastMilliseconds = 0;
+        int64_t LastPosition[3] = {};
+        int64_t LastSize = 0;
+        int32_t LastId = 0;
+        uint8_t LastColor[3] = { 255, 255, 255 };
+        int64_t LastRotation[3] = {};
+    };
+}
@@ -0,0 +1,107 @@
+#include "GenSnapshot.h"
+
+namespace GenCore
+{
+    namespace
+    {
+        uint64_t AlignUp(uint64_t Value)
+        {
+            return (Value + SnapshotAlignment - 1) & ~(SnapshotAlignment - 1);
+        }
+    }
+
+    void FSnapshotWriter::AddRawSection(uint32_t Type, uint32_t RecordSize, const void* Records, uint64_t Count)
+    {
+        FSnapshotSection Section;
+        Section.Type = Type;
+        Section.RecordSize = RecordSize;
+        Section.Count = Count;
+        Sections.push_back(Section);
+
+        const uint8_t* Bytes = static_cast<const uint8_t*>(Records);
+        Payloads.emplace_back(Bytes, Bytes + RecordSize * Count);
+    }
+
+    std::vector<uint8_t> FSnapshotWriter::Finalize()
+    {
+        uint64_t Offset = AlignUp(sizeof(FSnapshotHeader) + sizeof(FSnapshotSection) * Sections.size());
+        for (size_t i = 0; i < Sections.size(); ++i)
+        {
+            Sections[i].Offset = Offset;
+            Offset = AlignUp(Offset + Payloads[i].size());
+        }
+
+        FSnapshotHeader Header;
+        Header.SectionCount = static_cast<uint32_t>(Sections.size());
+        Header.FileSize = Offset;
+
+        std::vector<uint8_t> Image(static_cast<size_t>(Offset), 0);
+        std::memcpy(Image.data(), &Header, sizeof(Header));
+        if (!Sections.empty())
+        {
+            std::memcpy(Image.data() + sizeof(Header), Sections.data(), sizeof(FSnapshotSection) * Sections.size());
+        }
+        for (size_t i = 0; i < Sections.size(); ++i)
+        {
+            if (!Payloads[i].empty())
+            {
+                std::memcpy(Image.data() + Sections[i].Offset, Payloads[i].data(), Payloads[i].size());
+            }
+        }
+
+        Sections.clear();
+        Payloads.clear();
+        return Image;
+    }
+
+    uint64_t FSnapshotLayout::GetTableSize(const uint8_t* HeaderBytes, uint64_t Size)
+    {
+        if (Size < sizeof(FSnapshotHeader)) return sizeof(FSnapshotHeader);
+
+        FSnapshotHeader InHeader;
+        std::memcpy(&InHeader, HeaderBytes, sizeof(InHeader));
+        return static_cast<uint64_t>(InHeader.HeaderSize) + sizeof(FSnapshotSection) * static_cast<uint64_t>(InHeader.SectionCount);
+    }
+
+    ESnapshotError FSnapshotLayout::Parse(const uint8_t* Data, uint64_t Size, uint64_t FileSize)
+    {
+        Sections.clear();
+        if (Size < sizeof(FSnapshotHeader)) return ESnapshotError::TooSmall;
+
+        std::memcpy(&Header, Data, sizeof(Header));
+        if (Header.Magic != SnapshotMagic) return ESnapshotError::BadMagic;
+        if (Header.Version < MinSnapshotVersion || Header.Version > SnapshotVersion) return ESnapshotError::UnsupportedVersion;
+        if (Header.HeaderSize < sizeof(FSnapshotHeader) || Header.FileSize != FileSize) return ESnapshotError::Corrupt;
+
+        const uint64_t TableSize = GetTableSize(Data, Size);
+        if (Size < TableSize) return ESnapshotError::TooSmall;
+
+        Sections.resize(Header.SectionCount);
+        if (Header.SectionCount > 0)
+        {
+            std::memcpy(Sections.data(), Data + Header.HeaderSize, sizeof(FSnapshotSection) * Header.SectionCount);
+        }
+
+        for (const FSnapshotSection& Section : Sections)
+        {
+            const bool bAligned = Section.Offset % SnapshotAlignment == 0;
+            const bool bFits = Section.Offset >= TableSize && Section.Offset <= FileSize && Section.RecordSize > 0
+                && Section.Count <= (FileSize - Section.Offset) / Section.RecordSize;
+            if (!bAligned || !bFits)
+            {
+                Sections.clear();
+                return ESnapshotError::Corrupt;
+            }
+        }
+        return ESnapshotError::None;
+    }
+
+    const FSnapshotSection* FSnapshotLayout::FindSection(ESnapshotSection Type) const
+    {
+        for (const FSnapshotSection& Section : Sections)
+        {
+            if (Section.Type == static_cast<uint32_t>(Type)) return &Section;
+        }
+        return nullptr;
+    }
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+#include "GenCoreTypes.h"
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+// Versioned binary snapshot of generated layouts.
+//
+//   [FSnapshotHeader][FSnapshotSection x SectionCount][pad][records...][pad][records...]
+//
+// All sections start on a SnapshotAlignment boundary and records are fixed-size PODs, so a
+// memory-mapped file can be read in place, and any record range can be mapped on its own
+// (see FSnapshotLayout::GetRecordRange) to stream files that do not fit in memory.
+// Little-endian only.
+namespace GenCore
+{
+    constexpr uint32_t SnapshotMagic = 0x534E4547; // "GENS"
+    // Version 2: Poisson samples carry their rotation. Version 1 files still load, with upright samples.
+    constexpr uint16_t SnapshotVersion = 2;
+    constexpr uint16_t MinSnapshotVersion = 1;
+    constexpr uint64_t SnapshotAlignment = 16;
+
+    enum class ESnapshotSection : uint32_t
+    {
+        Circles = 1,
+        PoissonSamples = 2,
+        DLAVoxels = 3,
+        Primes = 4,
+    };
+
+    struct FSnapshotHeader
+    {
+        uint32_t Magic = SnapshotMagic;
+        uint16_t Version = SnapshotVersion;
+        uint16_t HeaderSize = sizeof(FSnapshotHeader);
+        uint32_t SectionCount = 0;
+        uint32_t Reserved = 0;
+        uint64_t FileSize = 0;
+    };
+    static_assert(sizeof(FSnapshotHeader) == 24, "Snapshot header layout changed");
+
+    struct FSnapshotSection
+    {
+        uint32_t Type = 0;
+        uint32_t RecordSize = 0;
+        uint64_t Offset = 0;
+        uint64_t Count = 0;
+    };
+    static_assert(sizeof(FSnapshotSection) == 24, "Snapshot section layout changed");
+
+    struct FSnapshotCircle
+    {
+        float X, Y;
+        float Radius;
+        float TargetRadius;
+        uint8_t R, G, B, A;
+    };
+    static_assert(sizeof(FSnapshotCircle) == 20, "Snapshot record layout changed");
+
+    struct FSnapshotPoissonSample
+    {
+        float X, Y, Z;
+        // Rotation quaternion (ground-aligned samples are tilted)
+        float QX, QY, QZ, QW;
+        uint16_t MeshId;
+        uint16_t Reserved;
+        uint8_t R, G, B, A;
+    };
+    static_assert(sizeof(FSnapshotPoissonSample) == 36, "Snapshot record layout changed");
+
+    // Version 1 Poisson record, without rotation. Same section; told apart by its record size.
+    struct FSnapshotPoissonSampleV1
+    {
+        float X, Y, Z;
+        uint16_t MeshId;
+        uint16_t Reserved;
+        uint8_t R, G, B, A;
+    };
+    static_assert(sizeof(FSnapshotPoissonSampleV1) == 20, "Snapshot record layout changed");
+
+    // Stored in stick order, record 0 is the seed.
+    struct FSnapshotVoxel
+    {
+        int16_t X, Y, Z;
+        int16_t Reserved;
+    };
+    static_assert(sizeof(FSnapshotVoxel) == 8, "Snapshot record layout changed");
+
+    struct FSnapshotPrime
+    {
+        int32_t Index;
+        int32_t GridX, GridY;
+    };
+    static_assert(sizeof(FSnapshotPrime) == 12, "Snapshot record layout changed");
+
+    template <typename RecordType> struct TSnapshotSectionOf;
+    template <> struct TSnapshotSectionOf<FSnapshotCircle> { static constexpr ESnapshotSection Value = ESnapshotSection::Circles; };
+    template <> struct TSnapshotSectionOf<FSnapshotPoissonSample> { static constexpr ESnapshotSection Value = ESnapshotSection::PoissonSamples; };
+    template <> struct TSnapshotSectionOf<FSnapshotPoissonSampleV1> { static constexpr ESnapshotSection Value = ESnapshotSection::PoissonSamples; };
+    template <> struct TSnapshotSectionOf<FSnapshotVoxel> { static constexpr ESnapshotSection Value = ESnapshotSection::DLAVoxels; };
+    template <> struct TSnapshotSectionOf<FSnapshotPrime> { static constexpr ESnapshotSection Value = ESnapshotSection::Primes; };
+
+    // Stick order in, records out: what the DLA actor saves, whether the cluster was grown, loaded or replayed.
+    inline std::vector<FSnapshotVoxel> MakeVoxelRecords(const std::vector<FInt3>& Voxels)
+    {
+        std::vector<FSnapshotVoxel> Records;
+        Records.reserve(Voxels.size());
+        for (const FInt3& Pos : Voxels)
+        {
+            Records.push_back({ static_cast<int16_t>(Pos.X), static_cast<int16_t>(Pos.Y), static_cast<int16_t>(Pos.Z), 0 });
+        }
+        return Records;
+    }
+
+    inline FInt3 ToVoxel(const FSnapshotVoxel& Record)
+    {
+        return FInt3(Record.X, Record.Y, Record.Z);
+    }
+
+    inline uint8_t ToUnorm8(float Value)
+    {
+        const float Clamped = Value < 0.f ? 0.f : (Value > 1.f ? 1.f : Value);
+        return static_cast<uint8_t>(Clamped * 255.f + 0.5f);
+    }
+
+    // Collects sections in memory and lays them out into one contiguous file image.
+    class FSnapshotWriter
+    {
+    public:
+        template <typename RecordType>
+        void AddSection(const RecordType* Records, uint64_t Count)
+        {
+            AddRawSection(static_cast<uint32_t>(TSnapshotSectionOf<RecordType>::Value), sizeof(RecordType), Records, Count);
+        }
+
+        template <typename RecordType>
+        void AddSection(const std::vector<RecordType>& Records)
+        {
+            AddSection(Records.data(), Records.size());
+        }
+
+        void AddRawSection(uint32_t Type, uint32_t RecordSize, const void* Records, uint64_t Count);
+
+        // Builds the file image. The writer can be reused afterwards.
+        std::vector<uint8_t> Finalize();
+
+    private:
+        std::vector<FSnapshotSection> Sections;
+        std::vector<std::vector<uint8_t>> Payloads;
+    };
+
+    enum class ESnapshotError : uint8_t
+    {
+        None,
+        TooSmall,
+        BadMagic,
+        UnsupportedVersion,
+        Corrupt,
+    };
+
+    // Parsed header + section table. Needs only the first GetTableSize() bytes of the file,
+    // so it can be built from a small mapped region before touching any record data.
+    class FSnapshotLayout
+    {
+    public:
+        // Bytes needed to parse the table; call with the header bytes first (at least sizeof(FSnapshotHeader)).
+        static uint64_t GetTableSize(const uint8_t* HeaderBytes, uint64_t Size);
+
+        // Parses header and section table. FileSize is the size of the whole file on disk.
+        ESnapshotError Parse(const uint8_t* Data, uint64_t Size, uint64_t FileSize);
+
+        const FSnapshotSection* FindSection(ESnapshotSection Type) const;
+
+        template <typename RecordType>
+        uint64_t GetRecordCount() const
+        {
+            const FSnapshotSection* Section = FindSection(TSnapshotSectionOf<RecordType>::Value);
+            return Section && Section->RecordSize == sizeof(RecordType) ? Section->Count : 0;
+        }
+
+        // Byte range in the file covering records [First, First + Count) of a section (clamped).
+        template <typename RecordType>
+        bool GetRecordRange(uint64_t First, uint64_t Count, uint64_t& OutOffset, uint64_t& OutSize) const
+        {
+            const FSnapshotSection* Section = FindSection(TSnapshotSectionOf<RecordType>::Value);
+            if (!Section || Section->RecordSize != sizeof(RecordType) || First >= Section->Count) return false;
+            Count = Count < Section->Count - First ? Count : Section->Count - First;
+            OutOffset = Section->Offset + First * sizeof(RecordType);
+            OutSize = Count * sizeof(RecordType);
+            return true;
+        }
+
+        // Direct view into a fully mapped file image (Data must be the start of the file).
+        template <typename RecordType>
+        const RecordType* GetRecords(const uint8_t* FileData, uint64_t& OutCount) const
+        {
+            OutCount = GetRecordCount<RecordType>();
+            return OutCount ? reinterpret_cast<const RecordType*>(FileData + FindSection(TSnapshotSectionOf<RecordType>::Value)->Offset) : nullptr;
+        }
+
+        const FSnapshotHeader& GetHeader() const { return Header; }
+
+    private:
+        FSnapshotHeader Header;
+        std::vector<FSnapshotSection> Sections;
+    };
+}
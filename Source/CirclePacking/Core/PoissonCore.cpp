@@ -0,0 +1,510 @@
+#include "PoissonCore.h"
+#include <algorithm>
+
+namespace GenCore
+{
+    void FPoissonSampler::Reset(const FPoissonParams& InParams, uint64_t Seed)
+    {
+        Params = InParams;
+        Random.Initialize(Seed);
+
+        // Each cell on the 2D grid can store only one point max. To avoid overlap,
+        // cell size ≈ radius / √2 so the cell diagonal equals the radius.
+        CellSize = Params.Radius / std::sqrt(2.f);
+
+        Samples.clear();
+        SampleRadii.clear();
+        SampleMeshes.clear();
+        ActiveList.clear();
+        Grid.clear();
+        Levels.clear();
+        DenseMinX = DenseMinY = DenseWidth = DenseHeight = 0;
+        DensePoints.clear();
+        DenseFilled.clear();
+
+        if (Params.IsVariableRadius())
+        {
+            float MinR = Params.RadiusAt ? Params.MinRadius : Params.Radius;
+            float MaxR = Params.RadiusAt ? Params.MaxRadius : Params.Radius;
+            for (float Spacing : Params.MeshMinSpacing)
+            {
+                MaxR = std::max(MaxR, Spacing);
+            }
+            LevelMinRadius = std::max(MinR, 1e-3f);
+            MaxR = std::max(MaxR, LevelMinRadius);
+
+            Levels.resize(static_cast<size_t>(std::floor(std::log2(MaxR / LevelMinRadius))) + 1);
+            for (size_t Level = 0; Level < Levels.size(); ++Level)
+            {
+                Levels[Level].CellSize = std::ldexp(LevelMinRadius, static_cast<int32_t>(Level)) / std::sqrt(2.f);
+            }
+        }
+    }
+
+    int32_t FPoissonSampler::Insert(const FVec2& Point, float SampleRadius, int32_t Mesh, bool bActivate)
+    {
+        const int32_t Index = static_cast<int32_t>(Samples.size());
+        Samples.push_back(Point);
+        SampleRadii.push_back(SampleRadius);
+        SampleMeshes.push_back(Mesh);
+        if (bActivate)
+            ActiveList.push_back(Index);
+
+        BoundsMin = Index == 0 ? Point : FVec2(std::min(BoundsMin.X, Point.X), std::min(BoundsMin.Y, Point.Y));
+        BoundsMax = Index == 0 ? Point : FVec2(std::max(BoundsMax.X, Point.X), std::max(BoundsMax.Y, Point.Y));
+
+        if (Levels.empty())
+        {
+            Grid[CellKey(ToCell(Point.X), ToCell(Point.Y))] = Index;
+            return Index;
+        }
+
+        const int32_t Level = LevelOf(SampleRadius);
+        for (int32_t Coarser = Level; Coarser < static_cast<int32_t>(Levels.size()); ++Coarser)
+        {
+            FLevel& Cells = Levels[Coarser];
+            const int64_t Key = CellKey(static_cast<int32_t>(std::floor(Point.X / Cells.CellSize)), static_cast<int32_t>(std::floor(Point.Y / Cells.CellSize)));
+            if (Coarser == Level)
+                Cells.Own[Key] = Index;
+            else
+                Cells.Cover[Key].push_back(Index);
+        }
+        return Index;
+    }
+
+    int32_t FPoissonSampler::AddSeed(const FVec2& Point)
+    {
+        if (Levels.empty()) return Insert(Point, Params.Radius, -1);
+
+        const int32_t Mesh = PickMesh();
+        return Insert(Point, RadiusFor(Point, Mesh), Mesh);
+    }
+
+    int32_t FPoissonSampler::AddExisting(const FVec2& Point, float SampleRadius, int32_t Mesh)
+    {
+        return Insert(Point, Levels.empty() ? Params.Radius : SampleRadius, Mesh, false);
+    }
+
+    float FPoissonSampler::RadiusFor(const FVec2& Point, int32_t Mesh) const
+    {
+        float SampleRadius = Params.Radius;
+        if (Params.RadiusAt)
+        {
+            SampleRadius = std::min(std::max(Params.RadiusAt(Point.X, Point.Y), Params.MinRadius), Params.MaxRadius);
+        }
+        if (Mesh >= 0)
+        {
+            SampleRadius = std::max(SampleRadius, Params.MeshMinSpacing[Mesh]);
+        }
+        return SampleRadius;
+    }
+
+    int32_t FPoissonSampler::PickMesh()
+    {
+        return Params.MeshMinSpacing.empty() ? -1 : Random.RandRange(0, static_cast<int32_t>(Params.MeshMinSpacing.size()) - 1);
+    }
+
+    int32_t FPoissonSampler::LevelOf(float SampleRadius) const
+    {
+        int32_t Level = static_cast<int32_t>(std::floor(std::log2(std::max(SampleRadius, LevelMinRadius) / LevelMinRadius)));
+        Level = std::min(Level, static_cast<int32_t>(Levels.size()) - 1);
+        // log2 rounding must never put a radius below its level's range (it would share a cell)
+        while (Level > 0 && SampleRadius < std::ldexp(LevelMinRadius, Level)) --Level;
+        return Level;
+    }
+
+    bool FPoissonSampler::IsInVariableNeighborhood(const FVec2& Point, float SampleRadius) const
+    {
+        const int32_t Level = LevelOf(SampleRadius);
+
+        // Same size or bigger samples: the reach on each level is bounded by the level's largest radius,
+        // i.e. under 2√2 cells, so the scan never exceeds 7x7 cells.
+        for (int32_t Coarser = Level; Coarser < static_cast<int32_t>(Levels.size()); ++Coarser)
+        {
+            const FLevel& Cells = Levels[Coarser];
+            if (Cells.Own.empty()) continue;
+
+            const float Reach = std::max(SampleRadius, std::ldexp(LevelMinRadius, Coarser + 1));
+            const int32_t MinX = static_cast<int32_t>(std::floor((Point.X - Reach) / Cells.CellSize));
+            const int32_t MaxX = static_cast<int32_t>(std::floor((Point.X + Reach) / Cells.CellSize));
+            const int32_t MinY = static_cast<int32_t>(std::floor((Point.Y - Reach) / Cells.CellSize));
+            const int32_t MaxY = static_cast<int32_t>(std::floor((Point.Y + Reach) / Cells.CellSize));
+            for (int32_t X = MinX; X <= MaxX; ++X)
+            {
+                for (int32_t Y = MinY; Y <= MaxY; ++Y)
+                {
+                    const auto It = Cells.Own.find(CellKey(X, Y));
+                    if (It == Cells.Own.end()) continue;
+
+                    const float MinDist = std::max(SampleRadius, SampleRadii[It->second]);
+                    if (FVec2::DistSquared(Samples[It->second], Point) < MinDist * MinDist)
+                        return true;
+                }
+            }
+        }
+
+        // Smaller samples only need to stay outside our own radius; they are all listed on our level's cells.
+        if (Level > 0 && !Levels[Level].Cover.empty())
+        {
+            const FLevel& Cells = Levels[Level];
+            const int32_t MinX = static_cast<int32_t>(std::floor((Point.X - SampleRadius) / Cells.CellSize));
+            const int32_t MaxX = static_cast<int32_t>(std::floor((Point.X + SampleRadius) / Cells.CellSize));
+            const int32_t MinY = static_cast<int32_t>(std::floor((Point.Y - SampleRadius) / Cells.CellSize));
+            const int32_t MaxY = static_cast<int32_t>(std::floor((Point.Y + SampleRadius) / Cells.CellSize));
+            const float RadiusSq = SampleRadius * SampleRadius;
+            for (int32_t X = MinX; X <= MaxX; ++X)
+            {
+                for (int32_t Y = MinY; Y <= MaxY; ++Y)
+                {
+                    const auto It = Cells.Cover.find(CellKey(X, Y));
+                    if (It == Cells.Cover.end()) continue;
+
+                    for (int32_t Other : It->second)
+                    {
+                        if (FVec2::DistSquared(Samples[Other], Point) < RadiusSq)
+                            return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    int32_t FPoissonSampler::GenerateNextPoint()
+    {
+        if (ActiveList.empty()) return -1;
+
+        //Pick a random point from active list
+        const int32_t Index = Random.RandRange(0, static_cast<int32_t>(ActiveList.size()) - 1);
+        const FVec2 Center = Samples[ActiveList[Index]];
+        const float CenterRadius = SampleRadii[ActiveList[Index]];
+
+        //Try K amount of times to find a new angle and distance and make sure its a good point
+        for (int32_t i = 0; i < Params.K; ++i)
+        {
+            const float Angle = Random.FRandRange(0.f, 2.f * GenPi);
+            //"You can plant a new tree anywhere 1–2 meters from this one."
+            const float R = Random.FRandRange(CenterRadius, 2.f * CenterRadius);
+            const FVec2 Candidate = Center + FVec2(std::cos(Angle), std::sin(Angle)) * R;
+
+            //make sure inside spawn area and its not too close to another points
+            if (FVec2::Distance(Candidate, Params.Center) > Params.ChunkSize) continue;
+
+            if (Levels.empty())
+            {
+                if (IsInNeighborhood(Candidate)) continue;
+                return Insert(Candidate, Params.Radius, -1);
+            }
+
+            const int32_t Mesh = PickMesh();
+            const float CandidateRadius = RadiusFor(Candidate, Mesh);
+            if (IsInVariableNeighborhood(Candidate, CandidateRadius)) continue;
+            return Insert(Candidate, CandidateRadius, Mesh);
+        }
+
+        //Retire the active point, order of the active list does not matter
+        ActiveList[Index] = ActiveList.back();
+        ActiveList.pop_back();
+        return -1;
+    }
+
+    void FPoissonSampler::Reseed(float ChunkGrowth, int32_t Count)
+    {
+        Params.ChunkSize += ChunkGrowth;
+
+        if (Samples.empty()) return;
+        for (int32_t i = 0; i < Count; ++i)
+        {
+            ActiveList.push_back(Random.RandRange(0, static_cast<int32_t>(Samples.size()) - 1));
+        }
+    }
+
+    bool FPoissonSampler::IsInNeighborhood(const FVec2& Point) const
+    {
+        if (!Levels.empty()) return IsInVariableNeighborhood(Point, RadiusFor(Point, -1));
+
+        const int32_t CellX = ToCell(Point.X);
+        const int32_t CellY = ToCell(Point.Y);
+        const float RadiusSq = Params.Radius * Params.Radius;
+
+        // Anything closer than Radius = √2 cells lies at most two cells away on each axis.
+        for (int32_t DX = -2; DX <= 2; ++DX)
+        {
+            for (int32_t DY = -2; DY <= 2; ++DY)
+            {
+                const auto It = Grid.find(CellKey(CellX + DX, CellY + DY));
+                if (It != Grid.end() && FVec2::DistSquared(Samples[It->second], Point) < RadiusSq)
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    FPoissonSampler::FRowSpan FPoissonSampler::MakeRowSpan(int32_t CellY, float Outer, float Inner) const
+    {
+        FRowSpan Span;
+        const float Y0 = CellY * CellSize - Params.Center.Y;
+        const float Y1 = Y0 + CellSize;
+        const float Near = std::max(0.f, std::max(Y0, -Y1));
+        if (Near > Outer) return Span;
+
+        const float Half = std::sqrt(Outer * Outer - Near * Near);
+        Span.Lo = ToCell(Params.Center.X - Half);
+        Span.Hi = ToCell(Params.Center.X + Half);
+
+        // Cells entirely inside the inner disc
+        const float Far = std::max(std::fabs(Y0), std::fabs(Y1));
+        if (Far < Inner)
+        {
+            const float HalfIn = std::sqrt(Inner * Inner - Far * Far);
+            Span.InLo = static_cast<int32_t>(std::ceil((Params.Center.X - HalfIn) / CellSize));
+            Span.InHi = static_cast<int32_t>(std::floor((Params.Center.X + HalfIn) / CellSize)) - 1;
+        }
+        return Span;
+    }
+
+    template <typename VisitorType>
+    void FPoissonSampler::ForEachSpanCell(const FRowSpan& Span, int32_t Stride, int32_t Phase, VisitorType&& Visit) const
+    {
+        auto VisitRange = [&](int32_t Lo, int32_t Hi)
+            {
+                // First cell of the phase (X ≡ Phase mod Stride)
+                const int32_t Offset = ((Lo - Phase) % Stride + Stride) % Stride;
+                for (int32_t X = Offset == 0 ? Lo : Lo + Stride - Offset; X <= Hi; X += Stride)
+                {
+                    Visit(X);
+                }
+            };
+
+        const int32_t Lo = std::max(Span.Lo, DenseMinX);
+        const int32_t Hi = std::min(Span.Hi, DenseMinX + DenseWidth - 1);
+        if (Span.InLo > Span.InHi)
+        {
+            VisitRange(Lo, Hi);
+            return;
+        }
+        VisitRange(Lo, std::min(Hi, Span.InLo - 1));
+        VisitRange(std::max(Lo, Span.InHi + 1), Hi);
+    }
+
+    int32_t FPoissonSampler::GenerateParallel(const FParallelForFn& ParallelFor, float InnerRadius)
+    {
+        const int32_t FirstNew = static_cast<int32_t>(Samples.size());
+        if (!Levels.empty()) return FirstNew;
+
+        const uint64_t PassSeed = MixSeed(Random.NextUInt32(), ++ParallelPass);
+
+        // Cells that may take a sample (the ring between InnerRadius and the chunk edge), and around them every cell
+        // whose sample could be a neighbour: a cell two cells away is less than three cells from the ring.
+        const float Margin = 3.f * CellSize;
+        const int32_t FirstRow = ToCell(Params.Center.Y - Params.ChunkSize);
+        const int32_t LastRow = ToCell(Params.Center.Y + Params.ChunkSize);
+        const int32_t FirstBinRow = FirstRow - 2;
+        const int32_t LastBinRow = LastRow + 2;
+
+        // The dense window only grows (by half again when outgrown), so a growing chunk reallocates rarely and a
+        // call costs the ring, not the whole chunk.
+        const int32_t NeedMinX = ToCell(Params.Center.X - Params.ChunkSize - Margin) - 1;
+        const int32_t NeedMaxX = ToCell(Params.Center.X + Params.ChunkSize + Margin) + 1;
+        const int32_t NeedMinY = FirstBinRow;
+        const int32_t NeedMaxY = LastBinRow;
+        if (NeedMinX < DenseMinX || NeedMinY < DenseMinY || NeedMaxX >= DenseMinX + DenseWidth || NeedMaxY >= DenseMinY + DenseHeight)
+        {
+            const int32_t SlackX = (NeedMaxX - NeedMinX + 1) / 4;
+            const int32_t SlackY = (NeedMaxY - NeedMinY + 1) / 4;
+            DenseMinX = NeedMinX - SlackX;
+            DenseMinY = NeedMinY - SlackY;
+            DenseWidth = NeedMaxX - NeedMinX + 1 + 2 * SlackX;
+            DenseHeight = NeedMaxY - NeedMinY + 1 + 2 * SlackY;
+            DensePoints.assign(static_cast<size_t>(DenseWidth) * DenseHeight, FVec2());
+            DenseFilled.assign(static_cast<size_t>(DenseWidth) * DenseHeight, 0);
+        }
+        auto DenseIndex = [this](int32_t X, int32_t Y) { return static_cast<size_t>(Y - DenseMinY) * DenseWidth + (X - DenseMinX); };
+
+        // Bin the existing samples around the ring from the sparse grid; cells outside it are never read
+        const float BinInner = std::max(InnerRadius - Margin, 0.f);
+        ActiveSpans.resize(LastRow - FirstRow + 1);
+        BinSpans.resize(LastBinRow - FirstBinRow + 1);
+        for (int32_t Y = FirstBinRow; Y <= LastBinRow; ++Y)
+        {
+            BinSpans[Y - FirstBinRow] = MakeRowSpan(Y, Params.ChunkSize + Margin, BinInner);
+            ForEachSpanCell(BinSpans[Y - FirstBinRow], 1, 0, [&](int32_t X)
+                {
+                    const size_t Cell = DenseIndex(X, Y);
+                    const auto It = Grid.find(CellKey(X, Y));
+                    DenseFilled[Cell] = It != Grid.end() ? 1 : 0;
+                    if (It != Grid.end())
+                        DensePoints[Cell] = Samples[It->second];
+                });
+        }
+        for (int32_t Y = FirstRow; Y <= LastRow; ++Y)
+        {
+            ActiveSpans[Y - FirstRow] = MakeRowSpan(Y, Params.ChunkSize, InnerRadius);
+        }
+
+        const float RadiusSq = Params.Radius * Params.Radius;
+        const float ChunkSq = Params.ChunkSize * Params.ChunkSize;
+
+        auto TryCell = [&](int32_t X, int32_t Y, FGenRandom& CellRandom)
+            {
+                const size_t Cell = DenseIndex(X, Y);
+                if (DenseFilled[Cell]) return;
+
+                const float CellMinX = X * CellSize;
+                const float CellMinY = Y * CellSize;
+                const FVec2 Candidate(CellMinX + CellRandom.FRand() * CellSize, CellMinY + CellRandom.FRand() * CellSize);
+                if (FVec2::DistSquared(Candidate, Params.Center) > ChunkSq) return;
+                // Float rounding can push a candidate onto the next cell's edge; the grid must stay one sample per cell
+                if (ToCell(Candidate.X) != X || ToCell(Candidate.Y) != Y) return;
+
+                for (int32_t NY = Y - 2; NY <= Y + 2; ++NY)
+                {
+                    for (int32_t NX = X - 2; NX <= X + 2; ++NX)
+                    {
+                        const size_t Neighbor = DenseIndex(NX, NY);
+                        if (DenseFilled[Neighbor] && FVec2::DistSquared(DensePoints[Neighbor], Candidate) < RadiusSq)
+                            return;
+                    }
+                }
+
+                DensePoints[Cell] = Candidate;
+                DenseFilled[Cell] = 2;
+            };
+
+        const int32_t NumRowsTotal = LastRow - FirstRow + 1;
+        for (int32_t Round = 0; Round < Params.K; ++Round)
+        {
+            for (int32_t Phase = 0; Phase < 9; ++Phase)
+            {
+                const int32_t PhaseX = Phase % 3;
+                const int32_t PhaseY = Phase / 3;
+                const int32_t NumRows = (NumRowsTotal - PhaseY + 2) / 3;
+
+                // One work item per row of the phase; the cells in it are three apart as well.
+                ParallelFor(NumRows, [&](int32_t Row)
+                    {
+                        const int32_t Y = FirstRow + PhaseY + Row * 3;
+                        FGenRandom RowRandom(MixSeed(PassSeed, static_cast<uint64_t>(Round * 9 + Phase), static_cast<uint64_t>(static_cast<uint32_t>(Y))));
+                        ForEachSpanCell(ActiveSpans[Y - FirstRow], 3, PhaseX, [&](int32_t X)
+                            {
+                                TryCell(X, Y, RowRandom);
+                            });
+                    });
+            }
+        }
+
+        // Publish in row-major cell order
+        for (int32_t Y = FirstRow; Y <= LastRow; ++Y)
+        {
+            ForEachSpanCell(ActiveSpans[Y - FirstRow], 1, 0, [&](int32_t X)
+                {
+                    const size_t Cell = DenseIndex(X, Y);
+                    if (DenseFilled[Cell] == 2)
+                    {
+                        DenseFilled[Cell] = 1;
+                        Insert(DensePoints[Cell], Params.Radius, -1, false);
+                    }
+                });
+        }
+        return FirstNew;
+    }
+
+    template <typename VisitorType>
+    void FPoissonSampler::ForEachInBox(const std::unordered_map<int64_t, int32_t>& Cells, float Size, const FVec2& Min, const FVec2& Max, VisitorType&& Visit) const
+    {
+        auto Inside = [&](const FVec2& Point) { return Point.X >= Min.X && Point.X <= Max.X && Point.Y >= Min.Y && Point.Y <= Max.Y; };
+
+        const int64_t MinX = static_cast<int64_t>(std::floor(Min.X / Size));
+        const int64_t MinY = static_cast<int64_t>(std::floor(Min.Y / Size));
+        const int64_t MaxX = static_cast<int64_t>(std::floor(Max.X / Size));
+        const int64_t MaxY = static_cast<int64_t>(std::floor(Max.Y / Size));
+
+        // A box much larger than the populated area is cheaper to answer by walking the occupied cells
+        if ((MaxX - MinX + 1) * (MaxY - MinY + 1) > static_cast<int64_t>(Cells.size()))
+        {
+            for (const auto& Pair : Cells)
+            {
+                if (Inside(Samples[Pair.second]))
+                    Visit(Pair.second);
+            }
+            return;
+        }
+
+        for (int64_t Y = MinY; Y <= MaxY; ++Y)
+        {
+            for (int64_t X = MinX; X <= MaxX; ++X)
+            {
+                const auto It = Cells.find(CellKey(static_cast<int32_t>(X), static_cast<int32_t>(Y)));
+                if (It != Cells.end() && Inside(Samples[It->second]))
+                    Visit(It->second);
+            }
+        }
+    }
+
+    void FPoissonSampler::QueryBox(const FVec2& Min, const FVec2& Max, std::vector<int32_t>& Out) const
+    {
+        if (Samples.empty() || Min.X > Max.X || Min.Y > Max.Y) return;
+
+        auto Add = [&Out](int32_t Index) { Out.push_back(Index); };
+        if (Levels.empty())
+        {
+            ForEachInBox(Grid, CellSize, Min, Max, Add);
+            return;
+        }
+        // Every sample is owned by exactly one level
+        for (const FLevel& Level : Levels)
+        {
+            ForEachInBox(Level.Own, Level.CellSize, Min, Max, Add);
+        }
+    }
+
+    void FPoissonSampler::QueryRadius(const FVec2& Center, float QueryRadius, std::vector<int32_t>& Out) const
+    {
+        const size_t First = Out.size();
+        QueryBox(Center - FVec2(QueryRadius, QueryRadius), Center + FVec2(QueryRadius, QueryRadius), Out);
+
+        const float RadiusSq = QueryRadius * QueryRadius;
+        Out.erase(std::remove_if(Out.begin() + First, Out.end(),
+            [&](int32_t Index) { return FVec2::DistSquared(Samples[Index], Center) > RadiusSq; }), Out.end());
+    }
+
+    void FPoissonSampler::QueryNearest(const FVec2& Point, int32_t Count, std::vector<int32_t>& Out, float MaxDistance, const std::function<bool(int32_t)>& Filter) const
+    {
+        if (Samples.empty() || Count <= 0) return;
+
+        // Farthest any sample can be; once the search disc reaches it, everything has been seen
+        const float FarX = std::max(std::fabs(Point.X - BoundsMin.X), std::fabs(Point.X - BoundsMax.X));
+        const float FarY = std::max(std::fabs(Point.Y - BoundsMin.Y), std::fabs(Point.Y - BoundsMax.Y));
+        const float Farthest = std::min(std::sqrt(FarX * FarX + FarY * FarY), MaxDistance);
+
+        // Grow the search disc until it holds Count samples: they are then the nearest ones.
+        std::vector<int32_t> Found;
+        float SearchRadius = std::min(2.f * (Levels.empty() ? CellSize : Levels[0].CellSize), Farthest);
+        for (;;)
+        {
+            Found.clear();
+            QueryRadius(Point, SearchRadius, Found);
+            if (Filter)
+                Found.erase(std::remove_if(Found.begin(), Found.end(), [&](int32_t Index) { return !Filter(Index); }), Found.end());
+
+            if (static_cast<int32_t>(Found.size()) >= Count || SearchRadius >= Farthest) break;
+            SearchRadius = std::min(SearchRadius * 2.f, Farthest);
+        }
+
+        const size_t Keep = std::min(Found.size(), static_cast<size_t>(Count));
+        std::partial_sort(Found.begin(), Found.begin() + Keep, Found.end(), [&](int32_t A, int32_t B)
+            {
+                const float DistA = FVec2::DistSquared(Samples[A], Point);
+                const float DistB = FVec2::DistSquared(Samples[B], Point);
+                return DistA < DistB || (DistA == DistB && A < B);
+            });
+        Out.insert(Out.end(), Found.begin(), Found.begin() + Keep);
+    }
+
+    int32_t FPoissonSampler::FindNearest(const FVec2& Point, float MaxDistance) const
+    {
+        std::vector<int32_t> Nearest;
+        QueryNearest(Point, 1, Nearest, MaxDistance);
+        return Nearest.empty() ? -1 : Nearest[0];
+    }
+}
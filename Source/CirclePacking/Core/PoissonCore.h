@@ -0,0 +1,158 @@
+#pragma once
+
+#include "GenCoreTypes.h"
+#include "GenRandom.h"
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace GenCore
+{
+    struct FPoissonParams
+    {
+        // Minimum distance between any two samples.
+        float Radius = 200.f;
+        // Candidates tried around an active point before it is retired.
+        int32_t K = 30;
+        // Samples are kept within ChunkSize of Center.
+        float ChunkSize = 2000.f;
+        FVec2 Center;
+
+        // Variable radius: each sample's radius is RadiusAt(X, Y) clamped to [MinRadius, MaxRadius]
+        // (Radius when RadiusAt is unset), raised to the spacing of the mesh picked for it.
+        // Two samples keep at least the larger of their radii apart.
+        std::function<float(float X, float Y)> RadiusAt;
+        float MinRadius = 0.f;
+        float MaxRadius = 0.f;
+        // Minimum spacing per mesh id. When set, the sampler picks each sample's mesh (uniformly).
+        std::vector<float> MeshMinSpacing;
+
+        bool IsVariableRadius() const { return static_cast<bool>(RadiusAt) || !MeshMinSpacing.empty(); }
+    };
+
+    // Incremental Bridson Poisson-disc sampler over a sparse background grid.
+    class FPoissonSampler
+    {
+    public:
+        void Reset(const FPoissonParams& InParams, uint64_t Seed);
+
+        // Adds a seed point unconditionally (sample + active + grid). Returns its sample index.
+        // In variable-radius mode the seed gets its radius and mesh like any other sample.
+        int32_t AddSeed(const FVec2& Point);
+
+        // One Bridson iteration around a random active point.
+        // Returns the index of the accepted sample, or -1 if the active point was retired (or none are left).
+        int32_t GenerateNextPoint();
+
+        // Once the active list is exhausted: grow the chunk and re-activate a few random samples.
+        void Reseed(float ChunkGrowth, int32_t Count);
+
+        // Fills the chunk disc in parallel, respecting every existing sample. Cells are processed in
+        // 3x3 phase groups: cells of one phase are three cells apart, beyond the reach of each other's
+        // 5x5 neighbourhood test, so they run concurrently without locks. Every empty cell gets K
+        // candidates, one per round. Cells lying entirely within InnerRadius of the center are never
+        // visited (use the previous chunk size to fill only a newly grown ring): a call costs the ring's area.
+        // New samples are appended in a fixed order, so the result does not depend on the thread count.
+        // Returns the index of the first new sample; they are not added to the active list.
+        // Uniform radius only: in variable-radius mode nothing is generated.
+        int32_t GenerateParallel(const FParallelForFn& ParallelFor, float InnerRadius = 0.f);
+
+        // Adds a sample without activating it, e.g. restored from a snapshot. It must keep the sampler's
+        // spacing (same params), since the grid holds one sample per cell. Returns its sample index.
+        int32_t AddExisting(const FVec2& Point, float SampleRadius, int32_t Mesh = -1);
+
+        bool IsInNeighborhood(const FVec2& Point) const;
+
+        // Spatial queries over all samples, answered from the sampling grid(s). They only read, so any number
+        // of threads may query at once as long as nothing generates at the same time.
+        // Results are sample indices, appended to Out.
+        void QueryBox(const FVec2& Min, const FVec2& Max, std::vector<int32_t>& Out) const;
+        void QueryRadius(const FVec2& Center, float QueryRadius, std::vector<int32_t>& Out) const;
+        // Up to Count samples within MaxDistance, nearest first. Filter (optional) skips samples it returns false for.
+        void QueryNearest(const FVec2& Point, int32_t Count, std::vector<int32_t>& Out,
+            float MaxDistance = std::numeric_limits<float>::max(), const std::function<bool(int32_t)>& Filter = nullptr) const;
+        // Nearest sample within MaxDistance, or -1
+        int32_t FindNearest(const FVec2& Point, float MaxDistance = std::numeric_limits<float>::max()) const;
+
+        const std::vector<FVec2>& GetSamples() const { return Samples; }
+        float GetSampleRadius(int32_t Index) const { return SampleRadii[Index]; }
+        // Mesh id picked by the sampler, or -1 when MeshMinSpacing is empty.
+        int32_t GetSampleMesh(int32_t Index) const { return SampleMeshes[Index]; }
+        int32_t GetActiveCount() const { return static_cast<int32_t>(ActiveList.size()); }
+        float GetCellSize() const { return CellSize; }
+        float GetChunkSize() const { return Params.ChunkSize; }
+        const FPoissonParams& GetParams() const { return Params; }
+
+    private:
+        int64_t CellKey(int32_t CellX, int32_t CellY) const
+        {
+            return (static_cast<int64_t>(CellX) << 32) ^ static_cast<int64_t>(static_cast<uint32_t>(CellY));
+        }
+        int32_t ToCell(float Coord) const { return static_cast<int32_t>(std::floor(Coord / CellSize)); }
+
+        int32_t Insert(const FVec2& Point, float SampleRadius, int32_t Mesh, bool bActivate = true);
+
+        // Calls Visit(SampleIndex) for every sample of one grid inside [Min, Max]
+        template <typename VisitorType>
+        void ForEachInBox(const std::unordered_map<int64_t, int32_t>& Cells, float Size, const FVec2& Min, const FVec2& Max, VisitorType&& Visit) const;
+
+        // Variable radius
+        float RadiusFor(const FVec2& Point, int32_t Mesh) const;
+        int32_t PickMesh();
+        int32_t LevelOf(float SampleRadius) const;
+        bool IsInVariableNeighborhood(const FVec2& Point, float SampleRadius) const;
+
+        FPoissonParams Params;
+        FGenRandom Random;
+        float CellSize = 0.f;
+
+        std::vector<FVec2> Samples;
+        std::vector<float> SampleRadii;
+        std::vector<int32_t> SampleMeshes;
+        // Bounding box of all samples, bounds the nearest-neighbour search
+        FVec2 BoundsMin;
+        FVec2 BoundsMax;
+        // Sample indices
+        std::vector<int32_t> ActiveList;
+        // Cell → sample index. A cell of size Radius/√2 can hold at most one sample.
+        std::unordered_map<int64_t, int32_t> Grid;
+
+        // Multi-resolution grid for variable radii. Level L holds radii in [LevelMinRadius·2^L, LevelMinRadius·2^(L+1))
+        // on cells of LevelMinRadius·2^L/√2, so again one sample per cell. Cover lists every smaller sample on
+        // the coarser cells, which keeps any query to 7x7 cells per level whatever the min/max radius ratio.
+        struct FLevel
+        {
+            float CellSize = 0.f;
+            std::unordered_map<int64_t, int32_t> Own;
+            std::unordered_map<int64_t, std::vector<int32_t>> Cover;
+        };
+        std::vector<FLevel> Levels;
+        float LevelMinRadius = 0.f;
+
+        // Dense scratch grid for GenerateParallel, in absolute cells from (DenseMinX, DenseMinY). It only grows;
+        // each call re-bins and fills just the cells around its ring.
+        int32_t DenseMinX = 0;
+        int32_t DenseMinY = 0;
+        int32_t DenseWidth = 0;
+        int32_t DenseHeight = 0;
+        std::vector<FVec2> DensePoints;
+        std::vector<uint8_t> DenseFilled;
+        uint64_t ParallelPass = 0;
+
+        // Cells [Lo, Hi] of one row, minus [InLo, InHi] (empty when InLo > InHi)
+        struct FRowSpan
+        {
+            int32_t Lo = 0;
+            int32_t Hi = -1;
+            int32_t InLo = 0;
+            int32_t InHi = -1;
+        };
+        // Cells of row CellY touching the disc of radius Outer around the center, minus those entirely within Inner
+        FRowSpan MakeRowSpan(int32_t CellY, float Outer, float Inner) const;
+        // Calls Visit(CellX) for the span's cells inside the dense window with X ≡ Phase mod Stride
+        template <typename VisitorType>
+        void ForEachSpanCell(const FRowSpan& Span, int32_t Stride, int32_t Phase, VisitorType&& Visit) const;
+        std::vector<FRowSpan> ActiveSpans;
+        std::vector<FRowSpan> BinSpans;
+    };
+}
@@ -0,0 +1,38 @@
+#include "PrimeSpiralCore.h"
+
+namespace GenCore
+{
+    bool IsPrime(int32_t Number)
+    {
+        if (Number < 2) return false;
+        if (Number % 2 == 0) return Number == 2;
+        // If Number is divisible by anything bigger than its square root, it would have already been caught by a smaller factor
+        for (int32_t i = 3; static_cast<int64_t>(i) * i <= Number; i += 2)
+        {
+            if (Number % i == 0) return false;
+        }
+        return true;
+    }
+
+    FInt2 GetUlamSpiralPosition(int32_t Index)
+    {
+        if (Index <= 1) return FInt2(0, 0);
+
+        // Ring M holds the indices ((2M-1)^2, (2M+1)^2]; the ring closes at its bottom-right corner.
+        int32_t M = static_cast<int32_t>(std::ceil((std::sqrt(static_cast<double>(Index)) - 1.0) / 2.0));
+        // Guard against sqrt rounding on perfect squares
+        while (static_cast<int64_t>(2 * M + 1) * (2 * M + 1) < Index) ++M;
+        while (M > 0 && static_cast<int64_t>(2 * M - 1) * (2 * M - 1) >= Index) --M;
+
+        const int32_t Side = 2 * M;
+        int64_t Corner = static_cast<int64_t>(Side + 1) * (Side + 1);
+
+        // Walk back from the closing corner one side at a time: bottom, left, top, right.
+        if (Index >= Corner - Side) return FInt2(M - static_cast<int32_t>(Corner - Index), -M);
+        Corner -= Side;
+        if (Index >= Corner - Side) return FInt2(-M, -M + static_cast<int32_t>(Corner - Index));
+        Corner -= Side;
+        if (Index >= Corner - Side) return FInt2(-M + static_cast<int32_t>(Corner - Index), M);
+        return FInt2(M, M - static_cast<int32_t>(Corner - Index - Side));
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "GenCoreTypes.h"
+
+namespace GenCore
+{
+    struct FInt2
+    {
+        int32_t X = 0;
+        int32_t Y = 0;
+
+        FInt2() = default;
+        FInt2(int32_t InX, int32_t InY) : X(InX), Y(InY) {}
+
+        bool operator==(const FInt2& Other) const { return X == Other.X && Y == Other.Y; }
+    };
+
+    bool IsPrime(int32_t Number);
+
+    //17 16 15 14 13
+    //18  5  4  3 12
+    //19  6  1  2 11
+    //20  7  8  9 10
+    //21 22 23 24 25
+    // Grid cell of Index on the Ulam spiral (1 = center, 2 = right, then counter-clockwise).
+    // Closed form, O(1) per index.
+    FInt2 GetUlamSpiralPosition(int32_t Index);
+}
@@ -0,0 +1,139 @@
+#include "VoxelMesher.h"
+#include <algorithm>
+
+namespace GenCore
+{
+    void GreedyMeshVoxels(const std::vector<FInt3>& MeshVoxels, const std::vector<FInt3>& Occluders, std::vector<FVoxelQuad>& Out)
+    {
+        if (MeshVoxels.empty()) return;
+
+        // Dense occupancy over the bounds of everything solid: 0 empty, 1 occluder, 2 meshed
+        FInt3 Lo = MeshVoxels[0];
+        FInt3 Hi = MeshVoxels[0];
+        auto Grow = [&Lo, &Hi](const FInt3& Voxel)
+            {
+                for (int32_t Axis = 0; Axis < 3; ++Axis)
+                {
+                    Lo[Axis] = std::min(Lo[Axis], Voxel[Axis]);
+                    Hi[Axis] = std::max(Hi[Axis], Voxel[Axis]);
+                }
+            };
+        for (const FInt3& Voxel : MeshVoxels) Grow(Voxel);
+        for (const FInt3& Voxel : Occluders) Grow(Voxel);
+
+        const FInt3 Size(Hi.X - Lo.X + 1, Hi.Y - Lo.Y + 1, Hi.Z - Lo.Z + 1);
+        std::vector<uint8_t> Cells(static_cast<size_t>(Size.X) * Size.Y * Size.Z, 0);
+        auto CellIndex = [&Size](const FInt3& Local) { return (static_cast<size_t>(Local.Z) * Size.Y + Local.Y) * Size.X + Local.X; };
+        auto CellAt = [&](const FInt3& Local) -> uint8_t
+            {
+                for (int32_t Axis = 0; Axis < 3; ++Axis)
+                {
+                    if (Local[Axis] < 0 || Local[Axis] >= Size[Axis]) return 0;
+                }
+                return Cells[CellIndex(Local)];
+            };
+        for (const FInt3& Voxel : Occluders)
+        {
+            uint8_t& Cell = Cells[CellIndex(FInt3(Voxel.X - Lo.X, Voxel.Y - Lo.Y, Voxel.Z - Lo.Z))];
+            Cell = std::max<uint8_t>(Cell, 1);
+        }
+        for (const FInt3& Voxel : MeshVoxels)
+        {
+            Cells[CellIndex(FInt3(Voxel.X - Lo.X, Voxel.Y - Lo.Y, Voxel.Z - Lo.Z))] = 2;
+        }
+
+        std::vector<uint8_t> Mask;
+        for (int32_t Axis = 0; Axis < 3; ++Axis)
+        {
+            // The slice spans axes U and V
+            const int32_t U = (Axis + 1) % 3;
+            const int32_t V = (Axis + 2) % 3;
+            Mask.assign(static_cast<size_t>(Size[U]) * Size[V], 0);
+
+            for (int32_t Side = 0; Side < 2; ++Side)
+            {
+                const bool bPositive = Side == 0;
+                for (int32_t Slice = 0; Slice < Size[Axis]; ++Slice)
+                {
+                    // Exposed faces of meshed voxels on this side
+                    FInt3 Local;
+                    Local[Axis] = Slice;
+                    for (int32_t J = 0; J < Size[V]; ++J)
+                    {
+                        for (int32_t I = 0; I < Size[U]; ++I)
+                        {
+                            Local[U] = I;
+                            Local[V] = J;
+                            FInt3 Neighbor = Local;
+                            Neighbor[Axis] += bPositive ? 1 : -1;
+                            Mask[static_cast<size_t>(J) * Size[U] + I] = CellAt(Local) == 2 && CellAt(Neighbor) == 0;
+                        }
+                    }
+
+                    // Merge: widest run along U first, then as many rows along V as the run fits
+                    for (int32_t J = 0; J < Size[V]; ++J)
+                    {
+                        for (int32_t I = 0; I < Size[U];)
+                        {
+                            if (!Mask[static_cast<size_t>(J) * Size[U] + I])
+                            {
+                                ++I;
+                                continue;
+                            }
+
+                            int32_t Width = 1;
+                            while (I + Width < Size[U] && Mask[static_cast<size_t>(J) * Size[U] + I + Width]) ++Width;
+
+                            int32_t Height = 1;
+                            for (; J + Height < Size[V]; ++Height)
+                            {
+                                const uint8_t* Row = &Mask[static_cast<size_t>(J + Height) * Size[U] + I];
+                                if (!std::all_of(Row, Row + Width, [](uint8_t Bit) { return Bit != 0; })) break;
+                            }
+
+                            for (int32_t H = 0; H < Height; ++H)
+                            {
+                                std::fill_n(&Mask[static_cast<size_t>(J + H) * Size[U] + I], Width, 0);
+                            }
+
+                            FVoxelQuad Quad;
+                            Quad.Axis = Axis;
+                            Quad.bPositive = bPositive;
+                            Quad.Min[Axis] = Quad.Max[Axis] = Lo[Axis] + Slice;
+                            Quad.Min[U] = Lo[U] + I;
+                            Quad.Max[U] = Lo[U] + I + Width - 1;
+                            Quad.Min[V] = Lo[V] + J;
+                            Quad.Max[V] = Lo[V] + J + Height - 1;
+                            Out.push_back(Quad);
+
+                            I += Width;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void GetQuadCorners(const FVoxelQuad& Quad, float Spacing, float HalfExtent, FVec3 OutCorners[4])
+    {
+        const int32_t U = (Quad.Axis + 1) % 3;
+        const int32_t V = (Quad.Axis + 2) % 3;
+
+        const float Plane = Quad.bPositive ? Quad.Max[Quad.Axis] * Spacing + HalfExtent : Quad.Min[Quad.Axis] * Spacing - HalfExtent;
+        const float U0 = Quad.Min[U] * Spacing - HalfExtent;
+        const float U1 = Quad.Max[U] * Spacing + HalfExtent;
+        const float V0 = Quad.Min[V] * Spacing - HalfExtent;
+        const float V1 = Quad.Max[V] * Spacing + HalfExtent;
+
+        // (U, V, Axis) is a right-handed frame, so U0V0 → U1V0 → U1V1 → U0V1 winds around +Axis
+        const float Us[4] = { U0, U1, U1, U0 };
+        const float Vs[4] = { V0, V0, V1, V1 };
+        for (int32_t Corner = 0; Corner < 4; ++Corner)
+        {
+            const int32_t Source = Quad.bPositive ? Corner : 3 - Corner;
+            OutCorners[Corner][Quad.Axis] = Plane;
+            OutCorners[Corner][U] = Us[Source];
+            OutCorners[Corner][V] = Vs[Source];
+        }
+    }
+}
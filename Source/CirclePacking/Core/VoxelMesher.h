@@ -0,0 +1,26 @@
+#pragma once
+
+#include "GenCoreTypes.h"
+#include <vector>
+
+namespace GenCore
+{
+    // A maximal rectangle of exposed voxel faces: the faces on side (Axis, bPositive) of every voxel in [Min, Max].
+    // Min and Max only differ on the two axes other than Axis.
+    struct FVoxelQuad
+    {
+        FInt3 Min;
+        FInt3 Max;
+        int32_t Axis = 0;
+        bool bPositive = true;
+    };
+
+    // Greedy meshing: every face of a MeshVoxels voxel that is not covered by a solid neighbour, merged slice by
+    // slice into maximal rectangles. Solid = MeshVoxels plus Occluders; occluders hide faces but get none themselves
+    // (e.g. voxels that stay instanced next to the merged part). Quads are appended to Out.
+    void GreedyMeshVoxels(const std::vector<FInt3>& MeshVoxels, const std::vector<FInt3>& Occluders, std::vector<FVoxelQuad>& Out);
+
+    // Corners of a quad for voxels centred at Index * Spacing with the given half extent, counter-clockwise
+    // seen from outside (right-handed; the outward normal is (C1 - C0) x (C2 - C0)).
+    void GetQuadCorners(const FVoxelQuad& Quad, float Spacing, float HalfExtent, FVec3 OutCorners[4]);
+}
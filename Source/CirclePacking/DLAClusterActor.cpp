@@ -2,7 +2,12 @@
 #include "Engine/StaticMesh.h"
 #include "DrawDebugHelpers.h"
 #include "Kismet/KismetMathLibrary.h"
-#include "Async/ParallelFor.h" // Add this at the top
+#include "GeneratorParallel.h"
+#include "GeneratorSnapshotFile.h"
+#include "Core/VoxelMesher.h"
+#include "Async/Async.h"
+#include "ProceduralMeshComponent.h"
+#include "Tasks/Task.h"
 
 ADLAClusterActor::ADLAClusterActor()
 {
@@ -12,21 +17,35 @@ ADLAClusterActor::ADLAClusterActor()
     RootComponent = MeshComponent;
     static ConstructorHelpers::FObjectFinder<UStaticMesh> CubeMesh(TEXT("/Engine/BasicShapes/Cube"));
     if (CubeMesh.Succeeded()) MeshComponent->SetStaticMesh(CubeMesh.Object);
+
+    FrozenMeshComponent = CreateDefaultSubobject<UProceduralMeshComponent>(TEXT("FrozenMesh"));
+    FrozenMeshComponent->SetupAttachment(MeshComponent);
+    FrozenMeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 }
 
 void ADLAClusterActor::BeginPlay()
 {
     Super::BeginPlay();
 
-    // One cube starts in the center — this is the seed.
-    FIntVector Seed = FIntVector::ZeroValue;
-    AggregatePoints.Add(Seed);
-    AddInstanceToMesh(Seed);
+    // One cube starts in the center — this is the seed. Walkers spawn on the bounds.
+    GenCore::FDLAParams Params;
+    Params.MaxWalkers = MaxWalkers;
+    Params.Bounds = Bounds;
+    if (Bounds > GenCore::LargeDLABounds)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("%s: Bounds %d allocates a %.0f MB occupancy grid"), *GetName(), Bounds,
+            GenCore::GetDLANearGridBytes(Bounds) / (1024.0 * 1024.0));
+    }
+    Simulation.Reset(Params, RandomSeed != 0 ? static_cast<uint64>(RandomSeed) : FPlatformTime::Cycles64());
+
+    const GenCore::FInt3& Seed = Simulation.GetAggregateOrder()[0];
+    AddInstanceToMesh(FIntVector(Seed.X, Seed.Y, Seed.Z));
 
-    // Spawn walkers
-    for (int32 i = 0; i < MaxWalkers; ++i)
+    // Voxels are recorded in grid units: a neighbour's offset fits in a byte per axis
+    if (bRecordReplay)
     {
-        Walkers.Add(FWalker(GetRandomEdgePosition()));
+        Recorder.Start(1.f);
+        RecordStick(Seed);
     }
 
     FVector Center = GetActorLocation();
@@ -40,6 +59,22 @@ void ADLAClusterActor::BeginPlay()
 
         GridSpacing = Diagonal * 0.28f;
     }
+
+    if (bLoadSnapshotOnBeginPlay)
+        LoadSnapshot();
+    else if (bPlayReplayOnBeginPlay)
+        PlayReplay();
+
+    if (bUseGeneratorSubsystem && IsActorTickEnabled() && !bReplaying)
+        UGeneratorSubsystem::RegisterActorJob(this, this);
+}
+
+void ADLAClusterActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    UGeneratorSubsystem::UnregisterActorJob(this, this);
+    if (Recorder.IsRecording() && Recorder.Num() > 0)
+        SaveReplay();
+    Super::EndPlay(EndPlayReason);
 }
 
 void ADLAClusterActor::Tick(float DeltaTime)
@@ -48,20 +83,75 @@ void ADLAClusterActor::Tick(float DeltaTime)
     //Calls SimulateStep() to move each walker one step.
     Super::Tick(DeltaTime);
 
-    for (const FWalker& Walker : Walkers)
+    //for (const GenCore::FInt3& Walker : Simulation.GetWalkers())
+    //{
+    //    FVector WorldPos = GetActorLocation() + FVector(Walker.X, Walker.Y, Walker.Z) * GridSpacing;
+    //    DrawDebugPoint(GetWorld(), WorldPos, 10.0f, FColor::Red, false, -1.0f, 0);
+    //}
+
+    if (bReplaying)
     {
-        FVector WorldPos = GetActorLocation() + FVector(Walker.Position) * GridSpacing;
-        //DrawDebugPoint(GetWorld(), WorldPos, 10.0f, FColor::Red, false, -1.0f, 0);
+        TickReplay(DeltaTime);
+        return;
     }
 
-	TimeAccumulator += DeltaTime;
-	if (TimeAccumulator < SimulationStepRate)
+    if (!PrepareGeneratorJob(DeltaTime))
+        return;
+
+    SimulateGeneratorJob(DeltaTime);
+    ApplyGeneratorJob();
+}
+
+bool ADLAClusterActor::PrepareGeneratorJob(float DeltaTime)
+{
+    SimulationScale = Throttle.Evaluate(this, Significance, DeltaTime);
+    if (SimulationScale <= 0.f)
+        return false;
+
+    Recorder.BeginFrame(GetWorld()->GetTimeSeconds());
+    return true;
+}
+
+void ADLAClusterActor::SimulateGeneratorJob(float DeltaTime)
+{
+    // Every step due runs (within GeneratorJob::MaxStepsPerRun), whether the time was deferred by the subsystem
+    // or skipped while throttled; the remainder carries over.
+	TimeAccumulator += DeltaTime * SimulationScale;
+    const int32 Steps = GeneratorJob::ConsumeSteps(TimeAccumulator, SimulationStepRate);
+	bSteppedThisFrame = Steps > 0;
+	if (!bSteppedThisFrame)
 		return;
+	StepDeltaTime = DeltaTime * SimulationScale;
+
+    SimulateStep(Steps);
+}
 
-	TimeAccumulator = 0.f;
+void ADLAClusterActor::ApplyGeneratorJob()
+{
+    if (!bSteppedThisFrame)
+        return;
+    bSteppedThisFrame = false;
 
-    SimulateStep();
+    // Apply all aggregation results on main thread
+    for (const GenCore::FInt3& Pos : StuckThisStep)
+    {
+        AddInstanceToMesh(FIntVector(Pos.X, Pos.Y, Pos.Z));
+        RecordStick(Pos);
+    }
 
+    AutoFreeze();
+    AnimateGrowth(StepDeltaTime);
+}
+
+void ADLAClusterActor::AutoFreeze()
+{
+    const int32 Settled = static_cast<int32>(GetVoxelOrder().size()) - FrontierVoxels;
+    if (AutoFreezeBatch > 0 && Settled - FrozenVoxelCount >= AutoFreezeBatch)
+        FreezeCluster();
+}
+
+void ADLAClusterActor::AnimateGrowth(float DeltaTime)
+{
     TArray<int32> Completed;
 
     for (auto& Pair : GrowingInstances)
@@ -93,169 +183,247 @@ void ADLAClusterActor::Tick(float DeltaTime)
 
 }
 
-void ADLAClusterActor::SimulateStep()
+void ADLAClusterActor::SimulateStep(int32 Steps)
 {
-    // Gradually reduce the number of active walkers over time to simulate slowing coral growth.
-    // For every 20 simulation steps, reduce the walker count by 1.
-    // Clamp to a minimum of 5 walkers to prevent growth from stalling completely.
-    ++StepCount;
-    int32 TargetWalkerCount = FMath::Max(5, MaxWalkers - StepCount / 90);
-    if (Walkers.Num() > TargetWalkerCount)
+    // Walkers move in parallel inside the core (the pool slowly shrinks to simulate slowing coral growth);
+    // whatever stuck this step comes back in stick order.
+    StuckThisStep.clear();
+    for (int32 i = 0; i < Steps; ++i)
     {
-        //No new walkers are added anymore, the pool just shrinks as the sim matures.
-        Walkers.SetNum(TargetWalkerCount);
+        Simulation.Step(GeneratorParallelFor, StuckThisStep);
     }
+}
 
-    // Store positions to add to the crystal later
-    TArray<FIntVector> PointsToAdd;
+void ADLAClusterActor::AddInstanceToMesh(const FIntVector& Pos, bool bAnimateGrowth)
+{
+    FVector Location = FVector(Pos) * GridSpacing;
 
-    // New walker array that we’ll fill during simulation
-    TArray<FWalker> UpdatedWalkers;
-    UpdatedWalkers.SetNumUninitialized(Walkers.Num());
+    FRotator RandomRot = FRotator(
+        FMath::RandRange(0.f, 360.f), // Pitch
+        FMath::RandRange(0.f, 360.f), // Yaw
+        FMath::RandRange(0.f, 360.f)  // Roll
+    );
 
-    // Protect shared access to AggregatePoints and PointsToAdd
-    FCriticalSection Mutex;
+    UStaticMesh* Mesh = MeshComponent->GetStaticMesh();
+    float HalfHeight = 50.0f;
+    if (Mesh)
+    {
+        FBox Box = Mesh->GetBoundingBox();
+        HalfHeight = Box.GetExtent().Z;
+    }
 
-    ParallelFor(Walkers.Num(), [&](int32 i)
-        {
-            FWalker Walker = Walkers[i];
+    if (!bAnimateGrowth)
+    {
+        MeshComponent->AddInstance(FTransform(RandomRot, Location, FVector::OneVector));
+        return;
+    }
 
-            // Determine direction toward the center on each axis (X, Y, Z)
-            // If walker is positive on an axis, move -1 (toward 0); if negative, move +1
-            // If already at 0 on that axis, don't move (set to 0)
-            //FIntVector DirectionToCenter(
-            //    Walker.Position.X == 0 ? 0 : (Walker.Position.X > 0 ? -1 : 1),
-            //    Walker.Position.Y == 0 ? 0 : (Walker.Position.Y > 0 ? -1 : 1),
-            //    Walker.Position.Z == 0 ? 0 : (Walker.Position.Z > 0 ? -1 : 1)
-            //);
+    int32 InstanceIndex = MeshComponent->AddInstance(FTransform(RandomRot, Location, FVector::ZeroVector));
+    GrowingInstances.Add(InstanceIndex, 0.0f);
 
-            //// Choose a random axis (0 = X, 1 = Y, 2 = Z) to move on
-            //int32 Axis = FMath::RandRange(0, 2);
-            //int32 Step = DirectionToCenter[Axis];
+    //FVector MeshCenterOffset(0, 0, HalfHeight);
+    //FVector RotatedOffset = RandomRot.RotateVector(MeshCenterOffset);
+    //FVector WorldPos = MeshComponent->GetComponentTransform().TransformPosition(Location + RotatedOffset);
 
-            // Get the directional step on that axis (inward)
-            // If already centered on that axis (step = 0), move randomly to prevent getting stuck
-            //if (Step == 0)
-            //    Step = FMath::RandBool() ? 1 : -1;
+	//DrawDebugSphere(GetWorld(), WorldPos, 45.0f, 12, FColor::Yellow, false, 1.0f);
+}
 
-            //Walker.Position[Axis] += Step;
+bool ADLAClusterActor::SaveSnapshot() const
+{
+    // A loaded or replayed cluster lives in LoadedVoxels, not in the simulation
+    GenCore::FSnapshotWriter Writer;
+    Writer.AddSection(GenCore::MakeVoxelRecords(GetVoxelOrder()));
+    return GeneratorSnapshot::WriteFile(GeneratorSnapshot::ResolvePath(this, SnapshotPath), Writer);
+}
 
-            // --- Pure 3D Random Walk (Brownian Motion) ---
-			Walker.Position.X += FMath::RandRange(-1, 1);
-			Walker.Position.Y += FMath::RandRange(-1, 1);
-			Walker.Position.Z += FMath::RandRange(-1, 1);
+bool ADLAClusterActor::LoadSnapshot()
+{
+    FGeneratorSnapshotReader Reader;
+    if (!Reader.Open(GeneratorSnapshot::ResolvePath(this, SnapshotPath)))
+        return false;
+    // A recording would not match the loaded layout
+    Recorder.Discard();
 
+    ClearCluster();
 
-            // Check if this walker is adjacent to any point in the aggregate
-            if (IsAdjacentToAggregate(Walker.Position))
+    Reader.ForEachBatch<GenCore::FSnapshotVoxel>(0, SnapshotMaxRecords, [this](const GenCore::FSnapshotVoxel* Records, int64 Count)
+        {
+            for (int64 i = 0; i < Count; ++i)
             {
-                // Lock and record this position for aggregation and mesh spawning
-                Mutex.Lock();
-                PointsToAdd.Add(Walker.Position);
-                Mutex.Unlock();
-
-                // Respawn walker at edge to keep constant walker count
-                Walker = FWalker(GetRandomEdgePosition());
+                const GenCore::FInt3 Pos = GenCore::ToVoxel(Records[i]);
+                AddInstanceToMesh(FIntVector(Pos.X, Pos.Y, Pos.Z), false);
+                LoadedVoxels.push_back(Pos);
             }
-            else
-            {
-                // If the walker's position exceeds the allowed grid boundary, respawn it
-                if (FMath::Abs(Walker.Position.X) > Bounds ||
-                    FMath::Abs(Walker.Position.Y) > Bounds ||
-                    FMath::Abs(Walker.Position.Z) > Bounds)
-                {
-                    Walker = FWalker(GetRandomEdgePosition());
-                }
-            }
-
-            UpdatedWalkers[i] = Walker;
         });
 
-    // Apply all recorded aggregation results on main thread
-    for (const FIntVector& Pos : PointsToAdd)
-    {
-        if (!AggregatePoints.Contains(Pos))
-        {
-            AggregatePoints.Add(Pos);
-            AddInstanceToMesh(Pos);
-        }
-    }
+    // The cluster is final, no more walking.
+    bReplaying = false;
+    Player.Stop();
+    SetActorTickEnabled(false);
+    UGeneratorSubsystem::UnregisterActorJob(this, this);
 
-    // Replace walkers with the updated set
-    Walkers = MoveTemp(UpdatedWalkers);
+    if (bFreezeLoadedSnapshot)
+        StartFreeze(0);
+    return true;
 }
 
-bool ADLAClusterActor::IsAdjacentToAggregate(const FIntVector& Pos) const
+void ADLAClusterActor::ClearCluster()
 {
-    //Old 6-direction check (axis only):
-    //static const TArray<FIntVector> Offsets = {
-    //    {1,0,0}, {-1,0,0},
-    //    {0,1,0}, {0,-1,0},
-    //    {0,0,1}, {0,0,-1}
-    //};
-    //New 26-direction check (all neighbors around a voxel):
-    // Checks if the given position is adjacent (in any direction) to an already aggregated crystal point.
-    // This includes all 26 neighboring positions in a 3x3x3 cube around the current voxel.
-    for (int32 X = -1; X <= 1; ++X)
-    {
-        for (int32 Y = -1; Y <= 1; ++Y)
-        {
-            for (int32 Z = -1; Z <= 1; ++Z)
-            {
-                if (X == 0 && Y == 0 && Z == 0)
-                    continue; // Skip self
+    MeshComponent->ClearInstances();
+    GrowingInstances.Empty();
+    FrozenMeshComponent->ClearAllMeshSections();
+    FrozenVoxelCount = 0;
+    bFreezeInFlight = false;
+    ++FreezeGeneration;
+    LoadedVoxels.clear();
+}
 
-                FIntVector Neighbor = Pos + FIntVector(X, Y, Z);
-                if (AggregatePoints.Contains(Neighbor))
-                    return true;
-            }
-        }
-    }
+void ADLAClusterActor::RecordStick(const GenCore::FInt3& Pos)
+{
+    GenCore::FReplayEvent Event;
+    Event.Type = GenCore::EReplayEventType::Stick;
+    Event.Position = GenCore::FVec3(static_cast<float>(Pos.X), static_cast<float>(Pos.Y), static_cast<float>(Pos.Z));
+    Recorder.Record(Event);
+}
 
-    // No adjacent aggregated neighbor found
-    return false;
+bool ADLAClusterActor::SaveReplay() const
+{
+    return Recorder.Save(GeneratorReplay::ResolvePath(this, ReplayPath), Player);
 }
 
-FIntVector ADLAClusterActor::GetRandomEdgePosition() const
+bool ADLAClusterActor::PlayReplay()
 {
-    FIntVector Pos;
-    int32 Axis = FMath::RandRange(0, 2);
-    int32 Side = FMath::RandBool() ? Bounds : -Bounds;
+    if (!Player.Open(GeneratorReplay::ResolvePath(this, ReplayPath)))
+        return false;
 
-    for (int32 i = 0; i < 3; ++i)
-    {
-		/*  Set the chosen axis to the edge(+Bounds or -Bounds).
-			Randomize the other two.*/
-        Pos[i] = (i == Axis) ? Side : FMath::RandRange(-Bounds, Bounds);
-    }
+    // Whatever was recorded so far (e.g. the BeginPlay seeds) is not what will be on screen
+    Recorder.Discard();
 
-    return Pos;
+    UGeneratorSubsystem::UnregisterActorJob(this, this);
+    ClearCluster();
+    bReplaying = true;
+    SetActorTickEnabled(true);
+    return true;
 }
 
-void ADLAClusterActor::AddInstanceToMesh(const FIntVector& Pos)
+void ADLAClusterActor::TickReplay(float DeltaTime)
 {
-    FVector Location = FVector(Pos) * GridSpacing;
+    // Stuck voxels come back in stick order, so freezing works on them as on a live cluster
+    Player.Advance(DeltaTime, ReplaySpeed, [this](const GenCore::FReplayEvent& Event)
+        {
+            const GenCore::FInt3 Pos(FMath::RoundToInt32(Event.Position.X), FMath::RoundToInt32(Event.Position.Y), FMath::RoundToInt32(Event.Position.Z));
+            AddInstanceToMesh(FIntVector(Pos.X, Pos.Y, Pos.Z));
+            LoadedVoxels.push_back(Pos);
+        });
 
-    FRotator RandomRot = FRotator(
-        FMath::RandRange(0.f, 360.f), // Pitch
-        FMath::RandRange(0.f, 360.f), // Yaw
-        FMath::RandRange(0.f, 360.f)  // Roll
-    );
+    AutoFreeze();
+    AnimateGrowth(DeltaTime * ReplaySpeed);
 
-    UStaticMesh* Mesh = MeshComponent->GetStaticMesh();
-    float HalfHeight = 50.0f;
-    if (Mesh)
+    if (!Player.IsPlaying() && GrowingInstances.Num() == 0)
     {
-        FBox Box = Mesh->GetBoundingBox();
-        HalfHeight = Box.GetExtent().Z;
+        bReplaying = false;
+        SetActorTickEnabled(false);
     }
+}
 
-    int32 InstanceIndex = MeshComponent->AddInstance(FTransform(RandomRot, Location, FVector::ZeroVector));
-    GrowingInstances.Add(InstanceIndex, 0.0f);
+bool ADLAClusterActor::FreezeCluster()
+{
+    return StartFreeze(FrontierVoxels);
+}
 
-    //FVector MeshCenterOffset(0, 0, HalfHeight);
-    //FVector RotatedOffset = RandomRot.RotateVector(MeshCenterOffset);
-    //FVector WorldPos = MeshComponent->GetComponentTransform().TransformPosition(Location + RotatedOffset);
+bool ADLAClusterActor::StartFreeze(int32 KeepInstanced)
+{
+    const std::vector<GenCore::FInt3>& Voxels = GetVoxelOrder();
+    const int32 NewFrozenCount = FMath::Max(0, static_cast<int32>(Voxels.size()) - FMath::Max(KeepInstanced, 0));
+    if (bFreezeInFlight || NewFrozenCount <= FrozenVoxelCount)
+        return false;
+
+    // The task works on copies; the walk carries on meanwhile. The frontier only hides faces.
+    std::vector<GenCore::FInt3> Settled(Voxels.begin(), Voxels.begin() + NewFrozenCount);
+    std::vector<GenCore::FInt3> Frontier(Voxels.begin() + NewFrozenCount, Voxels.end());
+    const float Spacing = GridSpacing;
+    float HalfExtent = GridSpacing * 0.5f;
+    if (UStaticMesh* Mesh = MeshComponent->GetStaticMesh())
+        HalfExtent = Mesh->GetBoundingBox().GetExtent().GetMax();
 
-	//DrawDebugSphere(GetWorld(), WorldPos, 45.0f, 12, FColor::Yellow, false, 1.0f);
+    bFreezeInFlight = true;
+    const int32 Generation = FreezeGeneration;
+    TWeakObjectPtr<ADLAClusterActor> WeakThis(this);
+    UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Generation, NewFrozenCount, Spacing, HalfExtent, Settled = MoveTemp(Settled), Frontier = MoveTemp(Frontier)]()
+        {
+            std::vector<GenCore::FVoxelQuad> Quads;
+            GenCore::GreedyMeshVoxels(Settled, Frontier, Quads);
+
+            TArray<FVector> Vertices;
+            TArray<int32> Triangles;
+            TArray<FVector> Normals;
+            TArray<FVector2D> UVs;
+            Vertices.Reserve(static_cast<int32>(Quads.size()) * 4);
+            Normals.Reserve(static_cast<int32>(Quads.size()) * 4);
+            UVs.Reserve(static_cast<int32>(Quads.size()) * 4);
+            Triangles.Reserve(static_cast<int32>(Quads.size()) * 6);
+
+            for (const GenCore::FVoxelQuad& Quad : Quads)
+            {
+                GenCore::FVec3 Corners[4];
+                GenCore::GetQuadCorners(Quad, Spacing, HalfExtent, Corners);
+
+                FVector Normal = FVector::ZeroVector;
+                Normal[Quad.Axis] = Quad.bPositive ? 1.0 : -1.0;
+                const int32 U = (Quad.Axis + 1) % 3;
+                const int32 V = (Quad.Axis + 2) % 3;
+
+                const int32 Base = Vertices.Num();
+                for (const GenCore::FVec3& Corner : Corners)
+                {
+                    Vertices.Add(FVector(Corner.X, Corner.Y, Corner.Z));
+                    Normals.Add(Normal);
+                    // One texture tile per voxel face
+                    UVs.Add(FVector2D(Corner[U], Corner[V]) / (2.f * HalfExtent));
+                }
+                // The core winds counter-clockwise; engine front faces are clockwise
+                Triangles.Append({ Base, Base + 2, Base + 1, Base, Base + 3, Base + 2 });
+            }
+
+            AsyncTask(ENamedThreads::GameThread, [WeakThis, Generation, NewFrozenCount, Vertices = MoveTemp(Vertices), Triangles = MoveTemp(Triangles), Normals = MoveTemp(Normals), UVs = MoveTemp(UVs)]()
+                {
+                    if (ADLAClusterActor* This = WeakThis.Get())
+                        This->ApplyFreeze(Generation, NewFrozenCount, Vertices, Triangles, Normals, UVs);
+                });
+        });
+    return true;
+}
+
+void ADLAClusterActor::ApplyFreeze(int32 Generation, int32 NewFrozenCount, const TArray<FVector>& Vertices, const TArray<int32>& Triangles, const TArray<FVector>& Normals, const TArray<FVector2D>& UVs)
+{
+    // A snapshot was loaded since this freeze started
+    if (Generation != FreezeGeneration)
+        return;
+    bFreezeInFlight = false;
+
+    FrozenMeshComponent->CreateMeshSection(0, Vertices, Triangles, Normals, UVs, TArray<FColor>(), TArray<FProcMeshTangent>(), /*bCreateCollision*/ false);
+    FrozenMeshComponent->SetMaterial(0, FrozenMaterial ? FrozenMaterial : MeshComponent->GetMaterial(0));
+
+    // The merged voxels are the oldest instances, at the front. Removing them one by one would shift the whole tail
+    // each time, so the surviving frontier is re-added in one batch, in the same order.
+    const int32 Removed = NewFrozenCount - FrozenVoxelCount;
+    TArray<FTransform> Survivors;
+    Survivors.Reserve(FMath::Max(MeshComponent->GetInstanceCount() - Removed, 0));
+    for (int32 Index = Removed; Index < MeshComponent->GetInstanceCount(); ++Index)
+    {
+        FTransform InstanceTransform;
+        MeshComponent->GetInstanceTransform(Index, InstanceTransform, /*bWorldSpace*/ false);
+        Survivors.Add(InstanceTransform);
+    }
+    MeshComponent->ClearInstances();
+    MeshComponent->AddInstances(Survivors, /*bShouldReturnIndices*/ false, /*bWorldSpace*/ false);
+
+    TMap<int32, float> Shifted;
+    for (const TPair<int32, float>& Pair : GrowingInstances)
+    {
+        if (Pair.Key >= Removed)
+            Shifted.Add(Pair.Key - Removed, Pair.Value);
+    }
+    GrowingInstances = MoveTemp(Shifted);
+    FrozenVoxelCount = NewFrozenCount;
 }
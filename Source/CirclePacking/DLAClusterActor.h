@@ -1,20 +1,15 @@
-﻿#pragma once
+#pragma once
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Components/InstancedStaticMeshComponent.h"
+#include "Core/DLACore.h"
+#include "GeneratorReplayFile.h"
+#include "GeneratorSignificance.h"
+#include "GeneratorSubsystem.h"
 #include "DLAClusterActor.generated.h"
 
-USTRUCT()
-struct FWalker
-{
-    GENERATED_BODY()
-
-    FIntVector Position;
-
-    FWalker() : Position(FIntVector::ZeroValue) {}
-    FWalker(FIntVector InPosition) : Position(InPosition) {}
-};
+class UProceduralMeshComponent;
 
 //Spawns a bunch of invisible “walkers”(agents).
 //These walkers randomly move around in 3D.
@@ -22,27 +17,58 @@ struct FWalker
 //The crystal keeps growing, like mold or snowflakes
 
 UCLASS()
-class CIRCLEPACKING_API ADLAClusterActor : public AActor
+class CIRCLEPACKING_API ADLAClusterActor : public AActor, public IGeneratorJob
 {
  GENERATED_BODY()
 
 public:
     ADLAClusterActor();
 
+    UFUNCTION(BlueprintCallable, Category = "Snapshot")
+    bool SaveSnapshot() const;
+
+    UFUNCTION(BlueprintCallable, Category = "Snapshot")
+    bool LoadSnapshot();
+
+    // Merges every voxel except the newest FrontierVoxels into one greedy-meshed surface (interior faces removed),
+    // built on a background task; those voxels' instances are removed once it is in place.
+    // Returns false if there is nothing new to merge or a freeze is still running.
+    UFUNCTION(BlueprintCallable, Category = "Freeze")
+    bool FreezeCluster();
+
+    UFUNCTION(BlueprintCallable, Category = "Replay")
+    bool SaveReplay() const;
+
+    // Clears the cluster and re-adds the recorded voxels in stick order at the recorded pace, without any walkers.
+    UFUNCTION(BlueprintCallable, Category = "Replay")
+    bool PlayReplay();
+
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void Tick(float DeltaTime) override;
 
+    // IGeneratorJob
+    virtual void SimulateGeneratorJob(float DeltaTime) override;
+    virtual void ApplyGeneratorJob() override;
+    virtual bool PrepareGeneratorJob(float DeltaTime) override;
+    virtual int32 GetGeneratorPriority() const override { return GeneratorPriority; }
+
 private:
-    void SimulateStep();
-    bool IsAdjacentToAggregate(const FIntVector& Pos) const;
-    FIntVector GetRandomEdgePosition() const;
-    void AddInstanceToMesh(const FIntVector& Pos);
+    void SimulateStep(int32 Steps = 1);
+    void AddInstanceToMesh(const FIntVector& Pos, bool bAnimateGrowth = true);
+    // Scales new cubes up over GrowthDuration
+    void AnimateGrowth(float DeltaTime);
+    void AutoFreeze();
+    // Drops every instance, the frozen surface and any loaded voxels
+    void ClearCluster();
 
     UPROPERTY(EditAnywhere)
     int32 MaxWalkers = 200;
 
-    UPROPERTY(EditAnywhere)
+    // Capped at GenCore::MaxDLABounds (512). Memory grows with the cube: the occupancy grid is about 1 MB at 100,
+    // 17 MB at 256 and 135 MB at 512 (a warning is logged above 256).
+    UPROPERTY(EditAnywhere, meta = (ClampMin = "1", ClampMax = "512"))
     int32 Bounds = 50;
 
 
@@ -50,21 +76,106 @@ private:
     //E.g., cube at(2, 1, 0) → world pos = (200, 100, 0)
     UPROPERTY(EditAnywhere)
     float GridSpacing = 100.0f;
-    //List of agents that move randomly
-    TArray<FWalker> Walkers;
-    //Stores all cubes that are part of the growing crystal
-    TSet<FIntVector> AggregatePoints;
+
+    // 0 = new cluster every play
+    UPROPERTY(EditAnywhere)
+    int32 RandomSeed = 0;
+
+    // Let the world's generator subsystem schedule this actor (simulation on a worker task, shared frame budget)
+    // instead of ticking it.
+    UPROPERTY(EditAnywhere, Category = "Scheduling")
+    bool bUseGeneratorSubsystem = false;
+
+    UPROPERTY(EditAnywhere, Category = "Scheduling", meta = (EditCondition = "bUseGeneratorSubsystem"))
+    int32 GeneratorPriority = 0;
+
+    // Slow down or pause while far away or off-screen, and catch up once relevant again.
+    UPROPERTY(EditAnywhere, Category = "Significance")
+    FGeneratorSignificanceSettings Significance;
+
+    // The newest voxels stay instances (still growing, still animating); everything older can be frozen.
+    UPROPERTY(EditAnywhere, Category = "Freeze")
+    int32 FrontierVoxels = 2000;
+
+    // Freeze automatically whenever this many voxels have aged out of the frontier (0 = only FreezeCluster).
+    UPROPERTY(EditAnywhere, Category = "Freeze")
+    int32 AutoFreezeBatch = 0;
+
+    // Freeze the whole loaded cluster after LoadSnapshot (it no longer grows).
+    UPROPERTY(EditAnywhere, Category = "Freeze")
+    bool bFreezeLoadedSnapshot = false;
+
+    // Material of the merged surface (empty = the instances' material)
+    UPROPERTY(EditAnywhere, Category = "Freeze")
+    UMaterialInterface* FrozenMaterial = nullptr;
+
+    // Empty = Saved/Snapshots/<ActorName>.gensnap
+    UPROPERTY(EditAnywhere, Category = "Snapshot")
+    FString SnapshotPath;
+
+    // Skip the walk and map the saved cluster straight into the instances.
+    UPROPERTY(EditAnywhere, Category = "Snapshot")
+    bool bLoadSnapshotOnBeginPlay = false;
+
+    // Load at most this many voxels in stick order (0 = all), e.g. to show the cluster at an earlier stage.
+    UPROPERTY(EditAnywhere, Category = "Snapshot")
+    int32 SnapshotMaxRecords = 0;
+
+    // Record every voxel as it sticks for PlayReplay; saved on EndPlay.
+    UPROPERTY(EditAnywhere, Category = "Replay")
+    bool bRecordReplay = false;
+
+    // Empty = Saved/Replays/<ActorName>.genreplay
+    UPROPERTY(EditAnywhere, Category = "Replay")
+    FString ReplayPath;
+
+    UPROPERTY(EditAnywhere, Category = "Replay")
+    bool bPlayReplayOnBeginPlay = false;
+
+    // 1 = the recorded pace
+    UPROPERTY(EditAnywhere, Category = "Replay", meta = (ClampMin = "0"))
+    float ReplaySpeed = 1.f;
+
+    FGeneratorReplayRecorder Recorder;
+    void RecordStick(const GenCore::FInt3& Pos);
+    // Replayed voxels go to LoadedVoxels, like a loaded snapshot
+    FGeneratorReplayPlayer Player;
+    bool bReplaying = false;
+    void TickReplay(float DeltaTime);
+
+    //Walkers and the aggregate live in the engine-independent core; this actor only spawns the cubes.
+    GenCore::FDLASimulation Simulation;
+    std::vector<GenCore::FInt3> StuckThisStep;
+    // Voxels of a loaded snapshot or replay in stick order (the simulation is not rebuilt from them)
+    std::vector<GenCore::FInt3> LoadedVoxels;
+    const std::vector<GenCore::FInt3>& GetVoxelOrder() const { return LoadedVoxels.empty() ? Simulation.GetAggregateOrder() : LoadedVoxels; }
+    // Set by the simulate phase for the apply phase
+    bool bSteppedThisFrame = false;
+    float StepDeltaTime = 0.f;
+
+    FGeneratorThrottle Throttle;
+    // Frames' worth of simulation for this frame (see FGeneratorThrottle)
+    float SimulationScale = 1.f;
 
     UPROPERTY(VisibleAnywhere)
     UInstancedStaticMeshComponent* MeshComponent;
 
+    UPROPERTY(VisibleAnywhere)
+    UProceduralMeshComponent* FrozenMeshComponent;
+
+    // Voxels [0, FrozenVoxelCount) of the stick order are in the merged surface; instance i is voxel FrozenVoxelCount + i.
+    int32 FrozenVoxelCount = 0;
+    bool bFreezeInFlight = false;
+    // Bumped by LoadSnapshot so a freeze started before it is dropped
+    int32 FreezeGeneration = 0;
+    bool StartFreeze(int32 KeepInstanced);
+    void ApplyFreeze(int32 Generation, int32 NewFrozenCount, const TArray<FVector>& Vertices, const TArray<int32>& Triangles, const TArray<FVector>& Normals, const TArray<FVector2D>& UVs);
+
     
     float TimeAccumulator = 0.f;
-	UPROPERTY(EditAnywhere)
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.001"))
 	float SimulationStepRate = 0.1f;
 
-    int32 StepCount = 0;
-
     TMap<int32, float> GrowingInstances;
 
 	UPROPERTY(EditAnywhere)
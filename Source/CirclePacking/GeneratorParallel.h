@@ -0,0 +1,11 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/ParallelFor.h"
+#include "Core/GenCoreTypes.h"
+
+// Engine ParallelFor in the shape the generator cores expect (GenCore::FParallelForFn).
+inline void GeneratorParallelFor(int32_t Num, const std::function<void(int32_t)>& Body)
+{
+    ParallelFor(Num, [&Body](int32 Index) { Body(Index); });
+}
@@ -0,0 +1,114 @@
+#include "GeneratorReplayFile.h"
+#include "GameFramework/Actor.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+FString GeneratorReplay::ResolvePath(const AActor* Actor, const FString& Path)
+{
+    if (Path.IsEmpty())
+    {
+        return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Replays"), Actor->GetName() + TEXT(".genreplay"));
+    }
+    return FPaths::IsRelative(Path) ? FPaths::Combine(FPaths::ProjectDir(), Path) : Path;
+}
+
+void FGeneratorReplayRecorder::Start(float PositionStep)
+{
+    Writer.Reset(PositionStep);
+    bRecording = true;
+    StartTime = -1.0;
+    Time = 0.0;
+    Frame = 0;
+}
+
+void FGeneratorReplayRecorder::Discard()
+{
+    Writer = GenCore::FReplayWriter();
+    bRecording = false;
+}
+
+void FGeneratorReplayRecorder::BeginFrame(double WorldTime)
+{
+    if (!bRecording)
+        return;
+
+    if (StartTime < 0.0)
+    {
+        StartTime = WorldTime;
+    }
+    else
+    {
+        ++Frame;
+    }
+    Time = WorldTime - StartTime;
+}
+
+void FGeneratorReplayRecorder::Record(GenCore::FReplayEvent Event)
+{
+    if (!bRecording)
+        return;
+
+    Event.Frame = Frame;
+    Event.Time = Time;
+    Writer.Add(Event);
+}
+
+bool FGeneratorReplayRecorder::Save(const FString& Filename, const FGeneratorReplayPlayer& Player) const
+{
+    if (Player.HasOpened(Filename))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Replay: not saving over %s, it is the replay being played"), *Filename);
+        return false;
+    }
+
+    const std::vector<uint8_t> Image = Writer.Finalize();
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(Filename), true);
+    if (!FFileHelper::SaveArrayToFile(TArrayView64<const uint8>(Image.data(), Image.size()), *Filename))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Replay: could not write %s"), *Filename);
+        return false;
+    }
+    return true;
+}
+
+bool FGeneratorReplayPlayer::Open(const FString& InFilename)
+{
+    bPlaying = false;
+    bHasPending = false;
+    Clock = 0.0;
+    Filename = InFilename;
+
+    Image.Reset();
+    if (!FFileHelper::LoadFileToArray(Image, *Filename))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Replay: could not read %s"), *Filename);
+        return false;
+    }
+
+    const GenCore::ESnapshotError Error = Reader.Open(Image.GetData(), Image.Num());
+    if (Error != GenCore::ESnapshotError::None)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Replay: %s is not a valid replay (error %d)"), *Filename, static_cast<int32>(Error));
+        return false;
+    }
+
+    bHasPending = Reader.Next(Pending);
+    bPlaying = true;
+    return true;
+}
+
+bool FGeneratorReplayPlayer::HasOpened(const FString& InFilename) const
+{
+    return !Filename.IsEmpty() && FPaths::IsSamePath(Filename, InFilename);
+}
+
+void FGeneratorReplayPlayer::Finish()
+{
+    if (Reader.GetError() != GenCore::ESnapshotError::None)
+        UE_LOG(LogTemp, Warning, TEXT("Replay: %s is cut short"), *Filename);
+
+    bPlaying = false;
+    Image.Empty();
+}
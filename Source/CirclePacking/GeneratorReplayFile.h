@@ -0,0 +1,88 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Core/GenReplay.h"
+
+class AActor;
+class FGeneratorReplayPlayer;
+
+// File side of GenCore replays (.genreplay): path resolution, recording during play, and paced playback.
+namespace GeneratorReplay
+{
+    // Empty path → Saved/Replays/<ActorName>.genreplay, relative paths resolve against the project dir.
+    FString ResolvePath(const AActor* Actor, const FString& Path);
+}
+
+// Collects an actor's generation events while it simulates.
+class FGeneratorReplayRecorder
+{
+public:
+    // PositionStep: the coarsest step that still reproduces the layout (1 for grid coordinates).
+    void Start(float PositionStep = 0.01f);
+    void Stop() { bRecording = false; }
+    // Stops and drops what was recorded, e.g. once the generator is cleared for a snapshot or a replay.
+    void Discard();
+    bool IsRecording() const { return bRecording; }
+
+    // Once per generator frame, before that frame's events, on the game thread.
+    void BeginFrame(double WorldTime);
+
+    // Stamps the current frame and time on the event.
+    void Record(GenCore::FReplayEvent Event);
+
+    int32 Num() const { return static_cast<int32>(Writer.GetEventCount()); }
+    // Refuses to overwrite the file Player has opened (an actor never saves over the replay it plays back).
+    bool Save(const FString& Filename, const FGeneratorReplayPlayer& Player) const;
+
+private:
+    GenCore::FReplayWriter Writer;
+    bool bRecording = false;
+    double StartTime = -1.0;
+    double Time = 0.0;
+    uint32 Frame = 0;
+};
+
+// Feeds a recorded stream back at its recorded pace (or scaled). Each advance decodes only the events that came due,
+// so playback costs nothing per frame beyond the events it emits.
+class FGeneratorReplayPlayer
+{
+public:
+    bool Open(const FString& Filename);
+    void Stop() { bPlaying = false; }
+    bool IsPlaying() const { return bPlaying; }
+    // True if Filename is the file last opened, playing or finished.
+    bool HasOpened(const FString& InFilename) const;
+
+    // Moves the playback clock on by DeltaTime * Speed and calls Visit(const GenCore::FReplayEvent&) for every event
+    // up to it. Returns false once the stream is used up.
+    template <typename VisitorType>
+    bool Advance(float DeltaTime, float Speed, VisitorType&& Visit)
+    {
+        if (!bPlaying)
+            return false;
+
+        Clock += DeltaTime * FMath::Max(Speed, 0.f);
+        while (bHasPending && Pending.Time <= Clock)
+        {
+            Visit(static_cast<const GenCore::FReplayEvent&>(Pending));
+            bHasPending = Reader.Next(Pending);
+        }
+
+        if (!bHasPending)
+            Finish();
+        return bPlaying;
+    }
+
+private:
+    void Finish();
+
+    // The reader decodes straight from this image
+    TArray64<uint8> Image;
+    FString Filename;
+    GenCore::FReplayReader Reader;
+    // Next event, already decoded
+    GenCore::FReplayEvent Pending;
+    bool bHasPending = false;
+    bool bPlaying = false;
+    double Clock = 0.0;
+};
@@ -0,0 +1,62 @@
+#include "GeneratorSignificance.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/PlayerController.h"
+
+namespace
+{
+    float ComputeRate(const AActor* Actor, const FGeneratorSignificanceSettings& Settings)
+    {
+        const UWorld* World = Actor->GetWorld();
+        if (!World) return 1.f;
+
+        // Distance to the nearest local view; without one (e.g. a dedicated server) nothing is throttled
+        const FBox Bounds = Actor->GetComponentsBoundingBox(/*bNonColliding*/ true);
+        float NearestSq = TNumericLimits<float>::Max();
+        for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+        {
+            const APlayerController* Controller = It->Get();
+            if (!Controller || !Controller->IsLocalController()) continue;
+
+            FVector ViewLocation;
+            FRotator ViewRotation;
+            Controller->GetPlayerViewPoint(ViewLocation, ViewRotation);
+            const float DistanceSq = Bounds.IsValid
+                ? static_cast<float>(Bounds.ComputeSquaredDistanceToPoint(ViewLocation))
+                : static_cast<float>(FVector::DistSquared(Actor->GetActorLocation(), ViewLocation));
+            NearestSq = FMath::Min(NearestSq, DistanceSq);
+        }
+        if (NearestSq == TNumericLimits<float>::Max()) return 1.f;
+
+        const float Distance = FMath::Sqrt(NearestSq);
+        if (Distance >= Settings.SuspendDistance) return 0.f;
+
+        float Rate = 1.f;
+        if (Distance > Settings.FullRateDistance)
+            Rate = 1.f - (Distance - Settings.FullRateDistance) / FMath::Max(Settings.SuspendDistance - Settings.FullRateDistance, 1.f);
+
+        // A generator that has not drawn anything yet counts as visible, or it would never start.
+        const bool bEverRendered = Actor->GetLastRenderTime() > 0.f;
+        if (bEverRendered && !Actor->WasRecentlyRendered(0.25f))
+            Rate = FMath::Min(Rate, Settings.OffScreenRate);
+
+        return Rate;
+    }
+}
+
+float FGeneratorThrottle::Evaluate(const AActor* Actor, const FGeneratorSignificanceSettings& Settings, float DeltaTime)
+{
+    if (!Settings.bEnabled || !Actor || DeltaTime <= 0.f) return 1.f;
+
+    const float Rate = ComputeRate(Actor, Settings);
+    if (Rate < 1.f)
+    {
+        OwedSeconds = FMath::Min(OwedSeconds + (1.f - Rate) * DeltaTime, Settings.MaxCatchUpSeconds);
+        return Rate;
+    }
+
+    // Relevant again: pay the skipped time back in slices
+    const float CatchUp = FMath::Min(OwedSeconds, Settings.CatchUpSecondsPerFrame);
+    OwedSeconds -= CatchUp;
+    return 1.f + CatchUp / DeltaTime;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GeneratorSignificance.generated.h"
+
+class AActor;
+
+// When a generator may slow down or pause because nobody can see it.
+USTRUCT(BlueprintType)
+struct FGeneratorSignificanceSettings
+{
+    GENERATED_BODY()
+
+    // Off = always full rate
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bEnabled = false;
+
+    // Full rate within this distance of the nearest player view (measured to the actor's bounds).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "bEnabled"))
+    float FullRateDistance = 5000.f;
+
+    // Suspended beyond this distance; the rate falls linearly in between.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "bEnabled"))
+    float SuspendDistance = 30000.f;
+
+    // Rate while the actor has not been rendered recently (0 = suspended).
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "bEnabled", ClampMin = "0", ClampMax = "1"))
+    float OffScreenRate = 0.f;
+
+    // Simulation time skipped while throttled is made up afterwards, up to this much.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "bEnabled"))
+    float MaxCatchUpSeconds = 5.f;
+
+    // Catch-up spread per frame, so it arrives as a few batched steps instead of one hitch.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "bEnabled"))
+    float CatchUpSecondsPerFrame = 0.5f;
+};
+
+// Turns significance into a per-frame simulation scale. Game thread only.
+class FGeneratorThrottle
+{
+public:
+    // Frames' worth of simulation to run now: 1 = full rate, below 1 = throttled (0 = suspended),
+    // above 1 = catching up on time skipped earlier.
+    float Evaluate(const AActor* Actor, const FGeneratorSignificanceSettings& Settings, float DeltaTime);
+
+private:
+    float OwedSeconds = 0.f;
+};
@@ -0,0 +1,62 @@
+#include "GeneratorSnapshotFile.h"
+#include "GameFramework/Actor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+FString GeneratorSnapshot::ResolvePath(const AActor* Actor, const FString& Path)
+{
+    if (Path.IsEmpty())
+    {
+        return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Snapshots"), Actor->GetName() + TEXT(".gensnap"));
+    }
+    return FPaths::IsRelative(Path) ? FPaths::Combine(FPaths::ProjectDir(), Path) : Path;
+}
+
+bool GeneratorSnapshot::WriteFile(const FString& Filename, GenCore::FSnapshotWriter& Writer)
+{
+    const std::vector<uint8_t> Image = Writer.Finalize();
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(Filename), true);
+    if (!FFileHelper::SaveArrayToFile(TArrayView64<const uint8>(Image.data(), Image.size()), *Filename))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Snapshot: could not write %s"), *Filename);
+        return false;
+    }
+    return true;
+}
+
+bool FGeneratorSnapshotReader::Open(const FString& Filename)
+{
+    Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+    if (!Handle)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Snapshot: could not map %s"), *Filename);
+        return false;
+    }
+
+    // Map just the header first, then the section table; record data is mapped per batch later.
+    const int64 FileSize = Handle->GetFileSize();
+    const int64 HeaderSize = FMath::Min<int64>(FileSize, sizeof(GenCore::FSnapshotHeader));
+    TUniquePtr<IMappedFileRegion> HeaderRegion(Handle->MapRegion(0, HeaderSize));
+    if (!HeaderRegion)
+    {
+        Handle.Reset();
+        return false;
+    }
+
+    const int64 TableSize = FMath::Min<int64>(FileSize, GenCore::FSnapshotLayout::GetTableSize(HeaderRegion->GetMappedPtr(), HeaderSize));
+    TUniquePtr<IMappedFileRegion> TableRegion(Handle->MapRegion(0, TableSize));
+    const GenCore::ESnapshotError Error = TableRegion
+        ? Layout.Parse(TableRegion->GetMappedPtr(), TableSize, FileSize)
+        : GenCore::ESnapshotError::TooSmall;
+
+    if (Error != GenCore::ESnapshotError::None)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Snapshot: %s is not a valid snapshot (error %d)"), *Filename, static_cast<int32>(Error));
+        Handle.Reset();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/MappedFileHandle.h"
+#include "Core/GenSnapshot.h"
+
+class AActor;
+
+// File side of GenCore snapshots (.gensnap): path resolution, writing, and mapped reading.
+namespace GeneratorSnapshot
+{
+    // Empty path → Saved/Snapshots/<ActorName>.gensnap, relative paths resolve against the project dir.
+    FString ResolvePath(const AActor* Actor, const FString& Path);
+
+    bool WriteFile(const FString& Filename, GenCore::FSnapshotWriter& Writer);
+}
+
+// Memory-maps a snapshot and hands out its records in batches.
+// Only one batch is mapped at a time, so files larger than RAM can be streamed.
+class FGeneratorSnapshotReader
+{
+public:
+    bool Open(const FString& Filename);
+
+    template <typename RecordType>
+    int64 Num() const
+    {
+        return static_cast<int64>(Layout.GetRecordCount<RecordType>());
+    }
+
+    // Calls Visit(const RecordType* Records, int64 Count) for records [First, First + MaxRecords)
+    // (MaxRecords <= 0 = to the end). Returns the number of records visited.
+    template <typename RecordType, typename VisitorType>
+    int64 ForEachBatch(int64 First, int64 MaxRecords, VisitorType&& Visit, int64 BatchRecords = 65536) const
+    {
+        const int64 Total = Num<RecordType>();
+        const int64 End = MaxRecords > 0 ? FMath::Min(Total, First + MaxRecords) : Total;
+
+        int64 Visited = 0;
+        for (int64 Begin = First; Begin < End; Begin += BatchRecords)
+        {
+            uint64 Offset = 0;
+            uint64 Size = 0;
+            if (!Layout.GetRecordRange<RecordType>(Begin, FMath::Min(BatchRecords, End - Begin), Offset, Size))
+                break;
+
+            TUniquePtr<IMappedFileRegion> Region(Handle->MapRegion(Offset, Size));
+            if (!Region)
+                break;
+
+            const int64 Count = Size / sizeof(RecordType);
+            Visit(reinterpret_cast<const RecordType*>(Region->GetMappedPtr()), Count);
+            Visited += Count;
+        }
+        return Visited;
+    }
+
+private:
+    TUniquePtr<IMappedFileHandle> Handle;
+    GenCore::FSnapshotLayout Layout;
+};
@@ -0,0 +1,139 @@
+#include "GeneratorSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+#include "Tasks/Task.h"
+
+namespace
+{
+    TAutoConsoleVariable<float> CVarGeneratorFrameBudgetMs(
+        TEXT("Generators.FrameBudgetMs"),
+        4.f,
+        TEXT("CPU time (summed over all worker threads) the generator subsystem may spend simulating per frame. ")
+        TEXT("Jobs that do not fit are deferred to a later frame; at least one job always runs."));
+
+    // A deferred job gains this much priority per frame it waits, so low priorities cannot starve.
+    constexpr int32 PriorityAgingPerFrame = 1;
+
+    // Time a deferred job can owe; the rest is dropped (jobs also cap their steps per run, see GeneratorJob).
+    constexpr float MaxPendingSeconds = 1.f;
+}
+
+void UGeneratorSubsystem::RegisterJob(IGeneratorJob* Job)
+{
+    check(IsInGameThread());
+    if (!Job || Jobs.ContainsByPredicate([Job](const TSharedPtr<FJobState>& State) { return State->Job == Job; }))
+        return;
+
+    TSharedPtr<FJobState> State = MakeShared<FJobState>();
+    State->Job = Job;
+    State->Order = NextOrder++;
+    Jobs.Add(State);
+}
+
+void UGeneratorSubsystem::UnregisterJob(IGeneratorJob* Job)
+{
+    check(IsInGameThread());
+    Jobs.RemoveAll([Job](const TSharedPtr<FJobState>& State)
+        {
+            if (State->Job != Job) return false;
+            // The current frame may still hold it
+            State->Job = nullptr;
+            return true;
+        });
+}
+
+bool UGeneratorSubsystem::RegisterActorJob(AActor* Actor, IGeneratorJob* Job)
+{
+    UWorld* World = Actor ? Actor->GetWorld() : nullptr;
+    UGeneratorSubsystem* Subsystem = World ? World->GetSubsystem<UGeneratorSubsystem>() : nullptr;
+    if (!Subsystem) return false;
+
+    Subsystem->RegisterJob(Job);
+    Actor->SetActorTickEnabled(false);
+    return true;
+}
+
+void UGeneratorSubsystem::UnregisterActorJob(AActor* Actor, IGeneratorJob* Job)
+{
+    UWorld* World = Actor ? Actor->GetWorld() : nullptr;
+    if (UGeneratorSubsystem* Subsystem = World ? World->GetSubsystem<UGeneratorSubsystem>() : nullptr)
+        Subsystem->UnregisterJob(Job);
+}
+
+void UGeneratorSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+    if (Jobs.Num() == 0) return;
+
+    for (const TSharedPtr<FJobState>& State : Jobs)
+    {
+        State->PendingDeltaTime = FMath::Min(State->PendingDeltaTime + DeltaTime, MaxPendingSeconds);
+    }
+
+    // Highest (aged) priority first
+    TArray<TSharedPtr<FJobState>> Ranked = Jobs;
+    auto RankOf = [](const FJobState& State) { return State.Job->GetGeneratorPriority() + State.FramesDeferred * PriorityAgingPerFrame; };
+    Ranked.StableSort([&RankOf](const TSharedPtr<FJobState>& A, const TSharedPtr<FJobState>& B) { return RankOf(*A) > RankOf(*B); });
+
+    // Fill the budget with the estimated costs; the rest waits a frame.
+    const double BudgetMs = CVarGeneratorFrameBudgetMs.GetValueOnGameThread();
+    double PlannedMs = 0.0;
+    TArray<TSharedPtr<FJobState>> Selected;
+    for (const TSharedPtr<FJobState>& State : Ranked)
+    {
+        if (Selected.Num() > 0 && PlannedMs + State->AverageMs > BudgetMs)
+        {
+            ++State->FramesDeferred;
+            continue;
+        }
+        PlannedMs += State->AverageMs;
+        Selected.Add(State);
+    }
+
+    Selected.RemoveAll([](const TSharedPtr<FJobState>& State)
+        {
+            if (State->Job->PrepareGeneratorJob(State->PendingDeltaTime)) return false;
+            State->PendingDeltaTime = 0.f;
+            State->FramesDeferred = 0;
+            return true;
+        });
+
+    // Simulation phases run concurrently
+    TArray<UE::Tasks::FTask> Tasks;
+    Tasks.Reserve(Selected.Num());
+    for (const TSharedPtr<FJobState>& State : Selected)
+    {
+        Tasks.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [Job = State->Job, PendingDeltaTime = State->PendingDeltaTime, LastMs = &State->LastMs]()
+            {
+                const double Start = FPlatformTime::Seconds();
+                Job->SimulateGeneratorJob(PendingDeltaTime);
+                *LastMs = (FPlatformTime::Seconds() - Start) * 1000.0;
+            }));
+    }
+    UE::Tasks::Wait(Tasks);
+
+    // One ordered apply phase: priority, then registration order
+    Selected.StableSort([](const TSharedPtr<FJobState>& A, const TSharedPtr<FJobState>& B)
+        {
+            const int32 PriorityA = A->Job->GetGeneratorPriority();
+            const int32 PriorityB = B->Job->GetGeneratorPriority();
+            return PriorityA != PriorityB ? PriorityA > PriorityB : A->Order < B->Order;
+        });
+    for (const TSharedPtr<FJobState>& State : Selected)
+    {
+        // Unregistered by an earlier job's apply
+        if (!State->Job) continue;
+
+        State->Job->ApplyGeneratorJob();
+
+        State->AverageMs = State->AverageMs == 0.0 ? State->LastMs : FMath::Lerp(State->AverageMs, State->LastMs, 0.2);
+        State->PendingDeltaTime = 0.f;
+        State->FramesDeferred = 0;
+    }
+}
+
+TStatId UGeneratorSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UGeneratorSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GeneratorSubsystem.generated.h"
+
+class AActor;
+
+// A generator the subsystem schedules instead of its own tick.
+// Simulate runs on a worker task, concurrently with other generators, and may only touch the generator's own
+// simulation state (the engine-independent core). Apply runs afterwards on the game thread, one job at a time,
+// and hands the results to components.
+class IGeneratorJob
+{
+public:
+    virtual ~IGeneratorJob() = default;
+
+    // DeltaTime covers every frame since the job last ran, including frames it was deferred (up to a second).
+    virtual void SimulateGeneratorJob(float DeltaTime) = 0;
+    // Game thread, just before the job is simulated. Returning false skips this frame (e.g. suspended while
+    // nobody can see it); the skipped time is dropped, the job accounts for it itself.
+    virtual bool PrepareGeneratorJob(float DeltaTime) { return true; }
+    virtual void ApplyGeneratorJob() = 0;
+
+    // Higher runs first and is deferred last when the frame budget runs out.
+    virtual int32 GetGeneratorPriority() const { return 0; }
+};
+
+namespace GeneratorJob
+{
+    // Most steps a generator runs in one simulate call. Time owed beyond that is dropped, not carried: a hitch or a
+    // steady overload would otherwise come back as ever larger bursts, and the frame budget could only postpone them.
+    constexpr int32 MaxStepsPerRun = 8;
+
+    // Takes the whole steps of StepSeconds out of Credit (seconds owed) and returns how many, at most MaxStepsPerRun;
+    // the remainder below one step carries over, anything beyond the cap is shed.
+    inline int32 ConsumeSteps(float& Credit, float StepSeconds)
+    {
+        StepSeconds = FMath::Max(StepSeconds, KINDA_SMALL_NUMBER);
+        const int32 Due = FMath::FloorToInt32(Credit / StepSeconds);
+        const int32 Steps = FMath::Clamp(Due, 0, MaxStepsPerRun);
+        Credit = Due > MaxStepsPerRun ? FMath::Fmod(Credit, StepSeconds) : Credit - Steps * StepSeconds;
+        return Steps;
+    }
+}
+
+// Runs all registered generators of a world as one batch per frame: simulation phases as parallel tasks within
+// a CPU budget (Generators.FrameBudgetMs), then one game-thread apply phase in priority order.
+UCLASS()
+class CIRCLEPACKING_API UGeneratorSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // Game thread only. A registered job must unregister before it is destroyed (e.g. in EndPlay).
+    void RegisterJob(IGeneratorJob* Job);
+    void UnregisterJob(IGeneratorJob* Job);
+
+    // Registers an actor's job with its world's subsystem and turns the actor's own tick off.
+    static bool RegisterActorJob(AActor* Actor, IGeneratorJob* Job);
+    static void UnregisterActorJob(AActor* Actor, IGeneratorJob* Job);
+
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+private:
+    struct FJobState
+    {
+        IGeneratorJob* Job = nullptr;
+        // Registration order, breaks priority ties so the apply order is stable
+        int32 Order = 0;
+        float PendingDeltaTime = 0.f;
+        // Smoothed simulate cost, used to fit jobs into the budget
+        double AverageMs = 0.0;
+        int32 FramesDeferred = 0;
+        // Written by the job's task
+        double LastMs = 0.0;
+    };
+
+    // Shared so a job registering or unregistering from its Apply cannot pull the state from under the running frame
+    TArray<TSharedPtr<FJobState>> Jobs;
+    int32 NextOrder = 0;
+};
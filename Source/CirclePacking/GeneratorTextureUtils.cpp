@@ -0,0 +1,61 @@
+#include "GeneratorTextureUtils.h"
+#include "Engine/Texture2D.h"
+
+bool GeneratorTexture::ReadLuminance(UTexture2D* Texture, TArray<float>& OutLuminance, FIntPoint& OutSize)
+{
+    const FTexturePlatformData* PlatformData = Texture ? Texture->GetPlatformData() : nullptr;
+    if (!PlatformData || PlatformData->Mips.Num() == 0)
+        return false;
+
+    const EPixelFormat Format = PlatformData->PixelFormat;
+    if (Format != PF_B8G8R8A8 && Format != PF_G8)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("%s: generator textures must be uncompressed BGRA8 or G8"), *Texture->GetName());
+        return false;
+    }
+
+    const FTexture2DMipMap& Mip = PlatformData->Mips[0];
+    const uint8* Pixels = static_cast<const uint8*>(Mip.BulkData.LockReadOnly());
+    if (!Pixels)
+    {
+        Mip.BulkData.Unlock();
+        return false;
+    }
+
+    OutSize = FIntPoint(Mip.SizeX, Mip.SizeY);
+    OutLuminance.SetNumUninitialized(OutSize.X * OutSize.Y);
+    for (int32 i = 0; i < OutLuminance.Num(); ++i)
+    {
+        if (Format == PF_G8)
+        {
+            OutLuminance[i] = Pixels[i] / 255.f;
+        }
+        else
+        {
+            const uint8* Pixel = Pixels + i * 4;
+            // Rec. 709 weights; the bytes are B, G, R, A
+            OutLuminance[i] = (0.0722f * Pixel[0] + 0.7152f * Pixel[1] + 0.2126f * Pixel[2]) / 255.f;
+        }
+    }
+    Mip.BulkData.Unlock();
+    return true;
+}
+
+float GeneratorTexture::SampleBilinear(const TArray<float>& Luminance, const FIntPoint& Size, const FVector2D& UV)
+{
+    if (Size.X <= 0 || Size.Y <= 0)
+        return 0.f;
+
+    const float X = FMath::Clamp(static_cast<float>(UV.X) * Size.X - 0.5f, 0.f, Size.X - 1.f);
+    const float Y = FMath::Clamp(static_cast<float>(UV.Y) * Size.Y - 0.5f, 0.f, Size.Y - 1.f);
+    const int32 X0 = FMath::FloorToInt32(X);
+    const int32 Y0 = FMath::FloorToInt32(Y);
+    const int32 X1 = FMath::Min(X0 + 1, Size.X - 1);
+    const int32 Y1 = FMath::Min(Y0 + 1, Size.Y - 1);
+    const float FX = X - X0;
+    const float FY = Y - Y0;
+
+    const float Top = FMath::Lerp(Luminance[Y0 * Size.X + X0], Luminance[Y0 * Size.X + X1], FX);
+    const float Bottom = FMath::Lerp(Luminance[Y1 * Size.X + X0], Luminance[Y1 * Size.X + X1], FX);
+    return FMath::Lerp(Top, Bottom, FY);
+}
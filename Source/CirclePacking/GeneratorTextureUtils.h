@@ -0,0 +1,17 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UTexture2D;
+
+// CPU-side reads of generator input textures (density maps, masks).
+namespace GeneratorTexture
+{
+    // Copies the top mip of Texture as luminance in [0, 1], row-major, Size.X * Size.Y values.
+    // Works on uncompressed BGRA8 or G8 textures (e.g. compression "VectorDisplacementmap" or "Grayscale",
+    // no mips); anything else logs a warning and returns false.
+    bool ReadLuminance(UTexture2D* Texture, TArray<float>& OutLuminance, FIntPoint& OutSize);
+
+    // Bilinear lookup at UV in [0, 1]² (clamped to the edges).
+    float SampleBilinear(const TArray<float>& Luminance, const FIntPoint& Size, const FVector2D& UV);
+}
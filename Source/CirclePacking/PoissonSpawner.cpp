@@ -1,8 +1,14 @@
 ﻿#include "PoissonSpawner.h"
 #include "Components/InstancedStaticMeshComponent.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Engine/World.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Curves/CurveFloat.h"
+#include "GeneratorTextureUtils.h"
+#include "GeneratorParallel.h"
+#include "GeneratorSnapshotFile.h"
+#include "Misc/ScopeRWLock.h"
 
 //Poisson - disc sampling makes natural - looking but non - overlapping distribution.
 //Useful for forests, rocks, NPCs, anything that needs space around it.
@@ -12,31 +18,14 @@ APoissonSpawner::APoissonSpawner()
     PrimaryActorTick.bCanEverTick = true;
 
     RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+
+    GroundTraceDelegate.BindUObject(this, &APoissonSpawner::OnGroundTraceDone);
 }
 
 void APoissonSpawner::BeginPlay()
 {
     Super::BeginPlay();
 
-    for (UStaticMesh* Mesh : MeshOptions)
-    {
-        if (!Mesh) continue;
-
-        FString Name = Mesh->GetName() + "_Instancer";
-        UInstancedStaticMeshComponent* NewInstancer = NewObject<UInstancedStaticMeshComponent>(this, FName(*Name));
-        NewInstancer->RegisterComponent();
-        NewInstancer->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
-        NewInstancer->SetStaticMesh(Mesh);
-
-        if (MaterialInstance)
-        {
-            NewInstancer->SetMaterial(0, MaterialInstance);
-            NewInstancer->NumCustomDataFloats = 3;
-        }
-
-        MeshToInstancer.Add(Mesh, NewInstancer);
-    }
-
     WorldCenter = FVector2D(GetActorLocation().X, GetActorLocation().Y);
     //STEP 0
 
@@ -50,7 +39,22 @@ void APoissonSpawner::BeginPlay()
     //│  ?  │ B   │
     //└─────┴─────┘
     // If A and B are in diagonal cells, they’re r = √2 × CellSize apart as thats the square diagonal as 2 is n which is the dimension we are working on
-    CellSize = Radius / FMath::Sqrt(2.0f);
+    // Queries may already run on other threads
+    SamplesLock.WriteLock();
+
+    // Before the seeds, so they are the first events
+    if (bRecordReplay)
+        Recorder.Start();
+
+    GenCore::FPoissonParams Params;
+    Params.Radius = Radius;
+    Params.K = K;
+    Params.ChunkSize = ChunkSize;
+    Params.Center = GenCore::FVec2(WorldCenter.X, WorldCenter.Y);
+    if (bVariableRadius)
+        SetupVariableRadius(Params);
+    Sampler.Reset(Params, RandomSeed != 0 ? static_cast<uint64>(RandomSeed) : FPlatformTime::Cycles64());
+    CellSize = Sampler.GetCellSize();
 
     //Imagine placing flags on a chessboard around the middle square. Each flag is a potential starting point for new trees.
     // this ensure safe spacing with starting seeds so if radius is 100 it should be 200 uu apart
@@ -86,7 +90,7 @@ void APoissonSpawner::BeginPlay()
     {
         // Top
         FVector2D Top(WorldCenter.X + FMath::Lerp(-Edge, Edge, t), WorldCenter.Y + Edge);
-        AddSample(Top); ActiveList.Add(Top); Grid.Add(FIntPoint(Top.X / CellSize, Top.Y / CellSize), Top);
+        AddSampleAt(Sampler.AddSeed(GenCore::FVec2(Top.X, Top.Y)));
 
         //// Bottom
         //FVector2D Bottom(WorldCenter.X + FMath::Lerp(-Edge, Edge, t), WorldCenter.Y - Edge);
@@ -101,128 +105,573 @@ void APoissonSpawner::BeginPlay()
         //AddSample(Right); ActiveList.Add(Right); Grid.Add(FIntPoint(Right.X / CellSize, Right.Y / CellSize), Right);
     }
 
+    SamplesLock.WriteUnlock();
+
+    if (bLoadSnapshotOnBeginPlay)
+        LoadSnapshot();
+    else if (bPlayReplayOnBeginPlay)
+        PlayReplay();
+    else if (bParallelFill && !bVariableRadius)
+        RunParallelFill(0.f);
+
+    DispatchGroundTraces();
+    FlushInstancers();
+
+    if (bUseGeneratorSubsystem && IsActorTickEnabled() && !bReplaying)
+        UGeneratorSubsystem::RegisterActorJob(this, this);
+}
+
+void APoissonSpawner::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    UGeneratorSubsystem::UnregisterActorJob(this, this);
+    if (Recorder.IsRecording() && Recorder.Num() > 0)
+        SaveReplay();
+    Super::EndPlay(EndPlayReason);
 }
 
 void APoissonSpawner::Tick(float DeltaTime)
 {
-    SpawnAccumulator += DeltaTime;
-    if (SpawnAccumulator < SpawnInterval) return;
-    SpawnAccumulator = 0.f;
+    if (bReplaying)
+    {
+        TickReplay(DeltaTime);
+        return;
+    }
+
+    if (!PrepareGeneratorJob(DeltaTime))
+        return;
+
+    SimulateGeneratorJob(DeltaTime);
+    ApplyGeneratorJob();
+}
+
+bool APoissonSpawner::PrepareGeneratorJob(float DeltaTime)
+{
+    SimulationScale = Throttle.Evaluate(this, Significance, DeltaTime);
+    if (SimulationScale <= 0.f)
+        return false;
+
+    Recorder.BeginFrame(GetWorld()->GetTimeSeconds());
+    return true;
+}
+
+void APoissonSpawner::SimulateGeneratorJob(float DeltaTime)
+{
+    // Every round due runs as one batch (within GeneratorJob::MaxStepsPerRun), whether the time was deferred by
+    // the subsystem or skipped while throttled; the remainder carries over.
+    SpawnAccumulator += DeltaTime * SimulationScale;
+    const int32 Rounds = GeneratorJob::ConsumeSteps(SpawnAccumulator, SpawnInterval);
+    if (Rounds == 0) return;
+
+    FRWScopeLock Lock(SamplesLock, SLT_Write);
+
+    if (bParallelFill && !bVariableRadius)
+    {
+        //Everything inside the chunk is already filled: grow it by one 200-unit ring per round due and fill only
+        //the new (wider) ring, in a single pass.
+        const float InnerRadius = Sampler.GetChunkSize();
+        Sampler.Reseed(Rounds * 200.f, 0);
+        ChunkSize = Sampler.GetChunkSize();
+
+        const int32 FirstNew = Sampler.GenerateParallel(GeneratorParallelFor, InnerRadius);
+        for (int32 i = FirstNew; i < static_cast<int32>(Sampler.GetSamples().size()); ++i)
+        {
+            NewSampleIndices.Add(i);
+        }
+        return;
+    }
 
     //If we have no active points left :
     //Expand the spawn range(ChunkSize).
     //Pick 5 old points to try again.
-    if (ActiveList.Num() == 0)
+    if (Sampler.GetActiveCount() == 0)
     {
-        ChunkSize += 200.f;
+        Sampler.Reseed(200.f, 5);
+        ChunkSize = Sampler.GetChunkSize();
+    }
 
-        if (Samples.Num() > 0)
+    //Try to spawn a new mesh near a random active point.
+    for (int32 i = 0; i < PointsPerTick * Rounds; ++i)
+    {
+        GenerateNextPoints();
+    }
+}
+
+void APoissonSpawner::ApplyGeneratorJob()
+{
+    {
+        FRWScopeLock Lock(SamplesLock, SLT_Write);
+        for (int32 SampleIndex : NewSampleIndices)
         {
-            for (int32 i = 0; i < 5; ++i)
-            {
-                FVector2D NewSeed = Samples[FMath::RandRange(0, Samples.Num() - 1)];
-                ActiveList.Add(NewSeed);
-            }
+            AddSampleAt(SampleIndex);
         }
+        NewSampleIndices.Reset();
     }
 
-    //Try to spawn a new mesh near a random active point.
-    for (int32 i = 0; i < PointsPerTick; ++i)
+    // Ground hits arrive between frames; keep traces flowing every frame, whatever the spawn interval.
+    if (bProjectToGround)
+        DispatchGroundTraces();
+
+    FlushInstancers();
+}
+
+void APoissonSpawner::RunParallelFill(float InnerRadius)
+{
+    FRWScopeLock Lock(SamplesLock, SLT_Write);
+    const int32 FirstNew = Sampler.GenerateParallel(GeneratorParallelFor, InnerRadius);
+
+    for (int32 i = FirstNew; i < static_cast<int32>(Sampler.GetSamples().size()); ++i)
     {
-        GenerateNextPoints();
+        AddSampleAt(i);
     }
+}
+
+void APoissonSpawner::SetupVariableRadius(GenCore::FPoissonParams& Params)
+{
+    if (bParallelFill)
+        UE_LOG(LogTemp, Warning, TEXT("%s: bParallelFill is ignored with bVariableRadius"), *GetName());
+
+    // Values set from code or Blueprint skip the ClampMin; a zero radius would stall sampling
+    Params.MinRadius = FMath::Max(MinRadius, 1.f);
+    Params.MaxRadius = FMath::Max(Params.MinRadius, MaxRadius);
+
+    // RadiusAt runs on worker threads, so it owns copies of everything it reads: the texture read back once here
+    // and a snapshot of the curve asset, never the actor or a UObject.
+    const TSharedRef<TArray<float>> Luminance = MakeShared<TArray<float>>();
+    FIntPoint LuminanceSize = FIntPoint::ZeroValue;
+    if (DensityTexture && !GeneratorTexture::ReadLuminance(DensityTexture, *Luminance, LuminanceSize))
+        Luminance->Reset();
+    TSharedPtr<const FRichCurve> Curve;
+    if (DensityCurve)
+        Curve = MakeShared<FRichCurve>(DensityCurve->FloatCurve);
+
+    // Density 1 → MinRadius, 0 → MaxRadius
+    const FVector2D Center = WorldCenter;
+    const float Extent = ChunkSize;
+    const float DenseRadius = Params.MinRadius;
+    const float SparseRadius = Params.MaxRadius;
+    Params.RadiusAt = [Luminance, LuminanceSize, Curve, Center, Extent, DenseRadius, SparseRadius](float X, float Y)
+        {
+            float Density = 1.f;
+            if (Luminance->Num() > 0)
+            {
+                const FVector2D UV = (FVector2D(X, Y) - Center + FVector2D(Extent)) / (2.f * Extent);
+                Density *= GeneratorTexture::SampleBilinear(*Luminance, LuminanceSize, UV);
+            }
+            if (Curve)
+            {
+                Density *= FMath::Clamp(Curve->Eval(FVector2D::Distance(FVector2D(X, Y), Center)), 0.f, 1.f);
+            }
+            return FMath::Lerp(SparseRadius, DenseRadius, Density);
+        };
 
-    for (auto& Pair : MeshToInstancer)
+    // The core picks the mesh so its spacing can be honoured; one entry per mesh slot.
+    if (MeshMinSpacing.Num() > 0)
     {
-        Pair.Value->MarkRenderStateDirty();
+        Params.MeshMinSpacing.assign(MeshOptions.Num(), 0.f);
+        for (int32 i = 0; i < FMath::Min(MeshOptions.Num(), MeshMinSpacing.Num()); ++i)
+        {
+            Params.MeshMinSpacing[i] = MeshMinSpacing[i];
+        }
     }
 }
 
-void APoissonSpawner::AddSample(const FVector2D& Point)
+void APoissonSpawner::AddSampleAt(int32 SampleIndex)
 {
-    //Convert the 2D point into a 3D position (X, Y, and actor’s Z).
-    FVector Location(Point.X, Point.Y, GetActorLocation().Z);
-    FTransform Transform(Location);
+    const GenCore::FVec2& Point = Sampler.GetSamples()[SampleIndex];
+    AddSample(SampleIndex, FVector2D(Point.X, Point.Y), Sampler.GetSampleMesh(SampleIndex));
+}
 
+void APoissonSpawner::AddSample(int32 SampleIndex, const FVector2D& Point, int32 MeshIndex)
+{
     if (MeshOptions.Num() == 0) return;
-    UStaticMesh* RandomMesh = MeshOptions[FMath::RandRange(0, MeshOptions.Num() - 1)];
-    UInstancedStaticMeshComponent* TargetInstancer = MeshToInstancer.FindRef(RandomMesh);
-    if (!TargetInstancer) return;
 
-    int32 Index = TargetInstancer->AddInstance(Transform);
+    //Convert the 2D point into a 3D position (X, Y, and actor’s Z).
+    FVector Location(Point.X, Point.Y, GetActorLocation().Z);
 
     //Use Perlin noise to generate a smooth, unique color.
     float Noise = FMath::PerlinNoise2D(Point * 0.001f);
     FLinearColor RandColor = FLinearColor::MakeFromHSV8(Noise * 255, 255, 255);
 
+    const FPoissonPendingSample Sample{ SampleIndex, MeshIndex != INDEX_NONE ? MeshIndex : FMath::RandRange(0, MeshOptions.Num() - 1), Location, RandColor };
+
+    //On uneven ground the height is only known once the trace is back
+    if (bProjectToGround)
+        PendingProjections.Add(Sample);
+    else
+        PlaceSample(Sample, FTransform(Location));
+}
+
+void APoissonSpawner::PlaceSample(const FPoissonPendingSample& Sample, const FTransform& Transform)
+{
+    // Samples still waiting on a ground trace have no instance yet; 0 would alias the first placed one
+    while (SampleToPlaced.Num() <= Sample.SampleIndex)
+        SampleToPlaced.Add(INDEX_NONE);
+    SampleToPlaced[Sample.SampleIndex] = SpawnInstance(Sample.MeshIndex, Transform, Sample.Color);
+
+    // Recorded as placed, after ground projection
+    if (Recorder.IsRecording())
+    {
+        const FVector Location = Transform.GetLocation();
+        const FRotator Rotation = Transform.Rotator();
+        GenCore::FReplayEvent Event;
+        Event.Position = GenCore::FVec3(Location.X, Location.Y, Location.Z);
+        Event.Rotation = GenCore::FVec3(Rotation.Pitch, Rotation.Yaw, Rotation.Roll);
+        Event.Id = Sample.MeshIndex;
+        Event.R = GenCore::ToUnorm8(Sample.Color.R);
+        Event.G = GenCore::ToUnorm8(Sample.Color.G);
+        Event.B = GenCore::ToUnorm8(Sample.Color.B);
+        Recorder.Record(Event);
+    }
+}
+
+void APoissonSpawner::DispatchGroundTraces()
+{
+    UWorld* World = GetWorld();
+    if (!World || PendingProjections.Num() == 0) return;
+
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(PoissonGroundTrace), /*bTraceComplex*/ false, this);
+    const float ActorZ = GetActorLocation().Z;
+
+    const int32 Count = FMath::Min(PendingProjections.Num(), FMath::Max(MaxGroundTracesPerFrame, 1));
+    for (int32 i = 0; i < Count; ++i)
+    {
+        const FPoissonPendingSample& Sample = PendingProjections[i];
+        const uint32 Id = NextProjectionId++;
+        ProjectionsInFlight.Add(Id, Sample);
+
+        const FVector Start(Sample.Location.X, Sample.Location.Y, ActorZ + GroundTraceHeight);
+        const FVector End(Sample.Location.X, Sample.Location.Y, ActorZ - GroundTraceDepth);
+        World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, GroundTraceChannel, QueryParams,
+            FCollisionResponseParams::DefaultResponseParam, &GroundTraceDelegate, Id);
+    }
+    PendingProjections.RemoveAt(0, Count, EAllowShrinking::No);
+}
+
+void APoissonSpawner::OnGroundTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+    FPoissonPendingSample Sample;
+    if (!ProjectionsInFlight.RemoveAndCopyValue(Datum.UserData, Sample)) return;
+
+    FTransform Transform(Sample.Location);
+    if (Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit)
+    {
+        const FHitResult& Hit = Datum.OutHits[0];
+        Transform.SetLocation(Hit.ImpactPoint);
+        if (bAlignToGroundNormal)
+            Transform.SetRotation(FRotationMatrix::MakeFromZ(Hit.ImpactNormal).ToQuat());
+    }
+
+    // Delivered on the game thread; flushed with the rest of the frame's instances in Tick
+    FRWScopeLock Lock(SamplesLock, SLT_Write);
+    PlaceSample(Sample, Transform);
+}
+
+int32 APoissonSpawner::SpawnInstance(int32 MeshIndex, const FTransform& Transform, const FLinearColor& Color)
+{
+    const FVector Location = Transform.GetLocation();
+    UInstancedStaticMeshComponent* TargetInstancer = GetOrCreateInstancer(MeshIndex, Location);
+    if (!TargetInstancer) return INDEX_NONE;
+
+    int32 Index = TargetInstancer->AddInstance(Transform);
+
     //Apply that color to the mesh (custom data floats).
-    TargetInstancer->SetCustomDataValue(Index, 0, RandColor.R, false);
-    TargetInstancer->SetCustomDataValue(Index, 1, RandColor.G, false);
-    TargetInstancer->SetCustomDataValue(Index, 2, RandColor.B, false);
+    TargetInstancer->SetCustomDataValue(Index, 0, Color.R, false);
+    TargetInstancer->SetCustomDataValue(Index, 1, Color.G, false);
+    TargetInstancer->SetCustomDataValue(Index, 2, Color.B, false);
 
-    //Add that point to the list of all samples.
-    Samples.Add(Point);
+    DirtyInstancers.Add(TargetInstancer);
+    return PlacedSamples.Add({ MeshIndex, TargetInstancer, Index, Location, Transform.GetRotation(), Color });
 }
 
-bool APoissonSpawner::IsInNeighborhood(const FVector2D& Point)
+UInstancedStaticMeshComponent* APoissonSpawner::GetOrCreateInstancer(int32 MeshIndex, const FVector& Location)
 {
-    //Converts the 2D point into a cell on a grid (like a square on a chessboard).
-    FIntPoint GridPos(Point.X / CellSize, Point.Y / CellSize);
-    
-    //Looks at the 25 nearby grid cells around it.
-    // only ones worth checking is near grid not the edges of grid
-    for (int32 dx = -5; dx <= 5; ++dx)
+    UStaticMesh* Mesh = MeshOptions.IsValidIndex(MeshIndex) ? MeshOptions[MeshIndex] : nullptr;
+    if (!Mesh) return nullptr;
+
+    const FIntVector Key(
+        MeshIndex,
+        TileSize > 0.f ? FMath::FloorToInt32(Location.X / TileSize) : 0,
+        TileSize > 0.f ? FMath::FloorToInt32(Location.Y / TileSize) : 0);
+
+    if (UInstancedStaticMeshComponent* Existing = TileInstancers.FindRef(Key))
+        return Existing;
+
+    const FName Name = MakeUniqueObjectName(this, UInstancedStaticMeshComponent::StaticClass(),
+        FName(*FString::Printf(TEXT("%s_Instancer_%d_%d"), *Mesh->GetName(), Key.Y, Key.Z)));
+
+    UInstancedStaticMeshComponent* NewInstancer = nullptr;
+    if (bUseHierarchicalInstancing)
     {
-        for (int32 dy = -5; dy <= 5; ++dy)
+        UHierarchicalInstancedStaticMeshComponent* Hierarchical = NewObject<UHierarchicalInstancedStaticMeshComponent>(this, Name);
+        // Samples arrive in bulk every tick; the tree is rebuilt once per batch in FlushInstancers instead.
+        Hierarchical->bAutoRebuildTreeOnInstanceChanges = false;
+        NewInstancer = Hierarchical;
+    }
+    else
+    {
+        NewInstancer = NewObject<UInstancedStaticMeshComponent>(this, Name);
+    }
+
+    NewInstancer->SetStaticMesh(Mesh);
+    NewInstancer->SetCullDistances(InstanceStartCullDistance, InstanceEndCullDistance);
+    if (MaterialInstance)
+    {
+        NewInstancer->SetMaterial(0, MaterialInstance);
+        NewInstancer->NumCustomDataFloats = 3;
+    }
+    NewInstancer->RegisterComponent();
+    NewInstancer->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
+
+    TileInstancers.Add(Key, NewInstancer);
+    return NewInstancer;
+}
+
+void APoissonSpawner::FlushInstancers()
+{
+    // Custom data is written without dirtying, so push the render state once per batch,
+    // and only for the tiles that actually received samples.
+    for (UInstancedStaticMeshComponent* Instancer : DirtyInstancers)
+    {
+        if (UHierarchicalInstancedStaticMeshComponent* Hierarchical = Cast<UHierarchicalInstancedStaticMeshComponent>(Instancer))
         {
-            FIntPoint NeighborKey = GridPos + FIntPoint(dx, dy);
-            if (FVector2D* Neighbor = Grid.Find(NeighborKey))
-            {
-                //Makes sure new points aren’t too close to any existing ones. It’s too close → skip this candidate.
-                if (FVector2D::Distance(*Neighbor, Point) < Radius)
-                    return true;
-            }
+            // The finished async build pushes its own render state; dirtying now would recreate the proxy with the stale tree
+            Hierarchical->BuildTreeIfOutdated(/*Async*/ true, /*ForceUpdate*/ false);
+            continue;
         }
+        Instancer->MarkRenderStateDirty();
     }
-    return false;
+    DirtyInstancers.Reset();
 }
 
 void APoissonSpawner::GenerateNextPoints()
 {
-    if (ActiveList.Num() == 0) return;
+    //Pick a random active point and try K candidates 1–2 radii away from it;
+    //the core retires the point if none of them keep their distance.
+    const int32 SampleIndex = Sampler.GenerateNextPoint();
+    if (SampleIndex == INDEX_NONE) return;
+
+    //spawn it (in the apply phase, on the game thread)
+    NewSampleIndices.Add(SampleIndex);
+}
+
+bool APoissonSpawner::SaveSnapshot() const
+{
+    FRWScopeLock Lock(SamplesLock, SLT_ReadOnly);
+
+    std::vector<GenCore::FSnapshotPoissonSample> Records;
+    Records.reserve(PlacedSamples.Num());
+    for (const FPoissonPlacedSample& Placed : PlacedSamples)
+    {
+        if (Placed.bRemoved) continue;
+        Records.push_back({ static_cast<float>(Placed.Location.X), static_cast<float>(Placed.Location.Y), static_cast<float>(Placed.Location.Z),
+            static_cast<float>(Placed.Rotation.X), static_cast<float>(Placed.Rotation.Y), static_cast<float>(Placed.Rotation.Z), static_cast<float>(Placed.Rotation.W),
+            static_cast<uint16>(Placed.MeshIndex), 0,
+            GenCore::ToUnorm8(Placed.Color.R), GenCore::ToUnorm8(Placed.Color.G), GenCore::ToUnorm8(Placed.Color.B), 255 });
+    }
+
+    GenCore::FSnapshotWriter Writer;
+    Writer.AddSection(Records);
+    return GeneratorSnapshot::WriteFile(GeneratorSnapshot::ResolvePath(this, SnapshotPath), Writer);
+}
+
+bool APoissonSpawner::LoadSnapshot()
+{
+    FGeneratorSnapshotReader Reader;
+    if (!Reader.Open(GeneratorSnapshot::ResolvePath(this, SnapshotPath)))
+        return false;
+    // A recording would not match the loaded layout
+    Recorder.Discard();
+
+    FRWScopeLock Lock(SamplesLock, SLT_Write);
+
+    // The loaded samples replace the sampled ones in the query grid as well
+    ClearSamples();
+    PlacedSamples.Reserve(static_cast<int32>(Reader.Num<GenCore::FSnapshotPoissonSample>() + Reader.Num<GenCore::FSnapshotPoissonSampleV1>()));
+
+    auto Place = [this](const auto& Record, const FQuat& Rotation)
+        {
+            Sampler.AddExisting(GenCore::FVec2(Record.X, Record.Y), Sampler.GetParams().MinRadius, Record.MeshId);
+            SampleToPlaced.Add(SpawnInstance(Record.MeshId, FTransform(Rotation, FVector(Record.X, Record.Y, Record.Z)), FLinearColor(Record.R / 255.f, Record.G / 255.f, Record.B / 255.f)));
+        };
+    Reader.ForEachBatch<GenCore::FSnapshotPoissonSample>(0, SnapshotMaxRecords, [&Place](const GenCore::FSnapshotPoissonSample* Records, int64 Count)
+        {
+            for (int64 i = 0; i < Count; ++i)
+            {
+                const GenCore::FSnapshotPoissonSample& Record = Records[i];
+                Place(Record, FQuat(Record.QX, Record.QY, Record.QZ, Record.QW).GetNormalized());
+            }
+        });
+    // Version 1 files (only one of the two layouts is ever present) load upright
+    Reader.ForEachBatch<GenCore::FSnapshotPoissonSampleV1>(0, SnapshotMaxRecords, [&Place](const GenCore::FSnapshotPoissonSampleV1* Records, int64 Count)
+        {
+            for (int64 i = 0; i < Count; ++i)
+            {
+                Place(Records[i], FQuat::Identity);
+            }
+        });
+
+    FlushInstancers();
+
+    // The layout is final, no more sampling.
+    bReplaying = false;
+    Player.Stop();
+    SetActorTickEnabled(false);
+    UGeneratorSubsystem::UnregisterActorJob(this, this);
+    return true;
+}
+
+void APoissonSpawner::ClearSamples()
+{
+    Sampler.Reset(Sampler.GetParams(), 0);
+    SampleToPlaced.Reset();
+    NewSampleIndices.Reset();
+    // Traces still out refer to the discarded samples
+    PendingProjections.Reset();
+    ProjectionsInFlight.Reset();
+
+    for (auto& Pair : TileInstancers)
+    {
+        Pair.Value->ClearInstances();
+        DirtyInstancers.Add(Pair.Value);
+    }
+    PlacedSamples.Reset();
+}
+
+bool APoissonSpawner::SaveReplay() const
+{
+    return Recorder.Save(GeneratorReplay::ResolvePath(this, ReplayPath), Player);
+}
+
+bool APoissonSpawner::PlayReplay()
+{
+    if (!Player.Open(GeneratorReplay::ResolvePath(this, ReplayPath)))
+        return false;
 
-    //Pick a random point from active list
-    int32 Index = FMath::RandRange(0, ActiveList.Num() - 1);
-    FVector2D Center = ActiveList[Index];
+    // Whatever was recorded so far (e.g. the BeginPlay seeds) is not what will be on screen
+    Recorder.Discard();
 
-    bool bFound = false;
-    //Try K amount of times to find a new angle and distance and make sure its a good point
-    for (int32 i = 0; i < K; ++i)
+    UGeneratorSubsystem::UnregisterActorJob(this, this);
     {
-        //STEP 2
-        //between 0 to 360 find an angle and get cose and sine or just a random 2d vector func and set its mag to R + point location
-        float Angle = FMath::RandRange(0.f, 2 * PI);
-        //“You can plant a new tree anywhere 1–2 meters from this one.”
-        float R = FMath::FRandRange(Radius, 2 * Radius);
-        //Turns the random angle into a 2D direction.
-        FVector2D Dir(FMath::Cos(Angle), FMath::Sin(Angle));
-        //multi dir by distance and add cetner to shift
-        FVector2D Candidate = Center + Dir * R;
-        //make sure inside spawn area and its not too close to another points
-        if (FVector2D::Distance(Candidate, WorldCenter) > ChunkSize) continue;
-        if (IsInNeighborhood(Candidate)) continue;
+        FRWScopeLock Lock(SamplesLock, SLT_Write);
+        ClearSamples();
+    }
+    FlushInstancers();
+    bReplaying = true;
+    SetActorTickEnabled(true);
+    return true;
+}
 
-        //spawn it
-        AddSample(Candidate);
-        ActiveList.Add(Candidate);
-        Grid.Add(FIntPoint(Candidate.X / CellSize, Candidate.Y / CellSize), Candidate);
-        bFound = true;
-        break;
+void APoissonSpawner::TickReplay(float DeltaTime)
+{
+    {
+        FRWScopeLock Lock(SamplesLock, SLT_Write);
+        Player.Advance(DeltaTime, ReplaySpeed, [this](const GenCore::FReplayEvent& Event)
+            {
+                // Placed as recorded (ground height and tilt included); the query grid follows the playback
+                const FVector Location(Event.Position.X, Event.Position.Y, Event.Position.Z);
+                const FRotator Rotation(Event.Rotation.X, Event.Rotation.Y, Event.Rotation.Z);
+                Sampler.AddExisting(GenCore::FVec2(Event.Position.X, Event.Position.Y), Sampler.GetParams().MinRadius, Event.Id);
+                SampleToPlaced.Add(SpawnInstance(Event.Id, FTransform(Rotation, Location), FLinearColor(Event.R / 255.f, Event.G / 255.f, Event.B / 255.f)));
+            });
     }
+    FlushInstancers();
 
-    //Remove the original point from the active list if it fails the distance and chunk size continue
-    if (!bFound)
+    if (!Player.IsPlaying())
     {
-        ActiveList.RemoveAt(Index);
+        bReplaying = false;
+        SetActorTickEnabled(false);
     }
 }
+
+TArray<FPoissonSampleHandle> APoissonSpawner::MakeHandles(const std::vector<int32_t>& SampleIndices) const
+{
+    TArray<FPoissonSampleHandle> Handles;
+    Handles.Reserve(static_cast<int32>(SampleIndices.size()));
+    for (int32 SampleIndex : SampleIndices)
+    {
+        const int32 PlacedIndex = SampleToPlaced.IsValidIndex(SampleIndex) ? SampleToPlaced[SampleIndex] : INDEX_NONE;
+        if (PlacedIndex == INDEX_NONE || PlacedSamples[PlacedIndex].bRemoved) continue;
+
+        const FPoissonPlacedSample& Placed = PlacedSamples[PlacedIndex];
+        Handles.Add({ SampleIndex, Placed.MeshIndex, Placed.Location, Placed.Instancer, Placed.InstanceIndex });
+    }
+    return Handles;
+}
+
+bool APoissonSpawner::FindNearestSample(const FVector& Location, float MaxDistance, FPoissonSampleHandle& OutSample) const
+{
+    const TArray<FPoissonSampleHandle> Nearest = FindNearestSamples(Location, 1, MaxDistance);
+    if (Nearest.Num() == 0) return false;
+
+    OutSample = Nearest[0];
+    return true;
+}
+
+TArray<FPoissonSampleHandle> APoissonSpawner::FindNearestSamples(const FVector& Location, int32 Count, float MaxDistance) const
+{
+    FRWScopeLock Lock(SamplesLock, SLT_ReadOnly);
+
+    // Skip unplaced and removed samples inside the search, so Count is still met
+    std::vector<int32_t> Found;
+    Sampler.QueryNearest(GenCore::FVec2(Location.X, Location.Y), Count, Found,
+        MaxDistance > 0.f ? MaxDistance : std::numeric_limits<float>::max(),
+        [this](int32_t SampleIndex)
+        {
+            const int32 PlacedIndex = SampleToPlaced.IsValidIndex(SampleIndex) ? SampleToPlaced[SampleIndex] : INDEX_NONE;
+            return PlacedIndex != INDEX_NONE && !PlacedSamples[PlacedIndex].bRemoved;
+        });
+    return MakeHandles(Found);
+}
+
+TArray<FPoissonSampleHandle> APoissonSpawner::FindSamplesInRadius(const FVector& Location, float QueryRadius) const
+{
+    FRWScopeLock Lock(SamplesLock, SLT_ReadOnly);
+
+    std::vector<int32_t> Found;
+    Sampler.QueryRadius(GenCore::FVec2(Location.X, Location.Y), QueryRadius, Found);
+    return MakeHandles(Found);
+}
+
+TArray<FPoissonSampleHandle> APoissonSpawner::FindSamplesInBox(const FBox& Box) const
+{
+    FRWScopeLock Lock(SamplesLock, SLT_ReadOnly);
+
+    std::vector<int32_t> Found;
+    Sampler.QueryBox(GenCore::FVec2(Box.Min.X, Box.Min.Y), GenCore::FVec2(Box.Max.X, Box.Max.Y), Found);
+    return MakeHandles(Found);
+}
+
+FPoissonPlacedSample* APoissonSpawner::FindPlaced(const FPoissonSampleHandle& Sample)
+{
+    const int32 PlacedIndex = SampleToPlaced.IsValidIndex(Sample.SampleIndex) ? SampleToPlaced[Sample.SampleIndex] : INDEX_NONE;
+    if (PlacedIndex == INDEX_NONE) return nullptr;
+
+    // Stale handles (from before a snapshot load) point at another instance
+    FPoissonPlacedSample& Placed = PlacedSamples[PlacedIndex];
+    return Placed.Instancer == Sample.Instancer && Placed.InstanceIndex == Sample.InstanceIndex ? &Placed : nullptr;
+}
+
+void APoissonSpawner::SetSampleHidden(const FPoissonSampleHandle& Sample, bool bHidden)
+{
+    check(IsInGameThread());
+    FRWScopeLock Lock(SamplesLock, SLT_Write);
+
+    FPoissonPlacedSample* Placed = FindPlaced(Sample);
+    if (!Placed || Placed->bRemoved || Placed->bHidden == bHidden) return;
+
+    // Instances cannot be hidden one by one; a zero scale drops them from rendering and keeps every index stable.
+    Placed->bHidden = bHidden;
+    const FTransform Transform(Placed->Rotation, Placed->Location, bHidden ? FVector::ZeroVector : FVector::OneVector);
+    Placed->Instancer->UpdateInstanceTransform(Placed->InstanceIndex, Transform, /*bWorldSpace*/ false, /*bMarkRenderStateDirty*/ false);
+    DirtyInstancers.Add(Placed->Instancer);
+    FlushInstancers();
+}
+
+void APoissonSpawner::RemoveSample(const FPoissonSampleHandle& Sample)
+{
+    SetSampleHidden(Sample, true);
+
+    FRWScopeLock Lock(SamplesLock, SLT_Write);
+    if (FPoissonPlacedSample* Placed = FindPlaced(Sample))
+        Placed->bRemoved = true;
+}
@@ -2,18 +2,119 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "HAL/CriticalSection.h"
+#include "Engine/EngineTypes.h"
+#include "WorldCollision.h"
+#include "Core/PoissonCore.h"
+#include "GeneratorReplayFile.h"
+#include "GeneratorSignificance.h"
+#include "GeneratorSubsystem.h"
 #include "PoissonSpawner.generated.h"
 
+class UTexture2D;
+class UCurveFloat;
+
+// One placed instance, kept so the layout can be written out again.
+struct FPoissonPlacedSample
+{
+    // Slot in MeshOptions
+    int32 MeshIndex = INDEX_NONE;
+    UInstancedStaticMeshComponent* Instancer = nullptr;
+    int32 InstanceIndex = INDEX_NONE;
+    FVector Location = FVector::ZeroVector;
+    FQuat Rotation = FQuat::Identity;
+    FLinearColor Color = FLinearColor::White;
+    bool bHidden = false;
+    // Removed samples stay hidden, drop out of queries and snapshots, and keep their spacing (no refill).
+    bool bRemoved = false;
+};
+
+// An accepted sample waiting for its ground trace.
+struct FPoissonPendingSample
+{
+    int32 SampleIndex = INDEX_NONE;
+    int32 MeshIndex = INDEX_NONE;
+    FVector Location = FVector::ZeroVector;
+    FLinearColor Color = FLinearColor::White;
+};
+
+// A generated sample and the instance that renders it, as returned by the spatial queries.
+USTRUCT(BlueprintType)
+struct FPoissonSampleHandle
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    int32 SampleIndex = INDEX_NONE;
+
+    // Slot in MeshOptions
+    UPROPERTY(BlueprintReadOnly)
+    int32 MeshIndex = INDEX_NONE;
+
+    UPROPERTY(BlueprintReadOnly)
+    FVector Location = FVector::ZeroVector;
+
+    UPROPERTY(BlueprintReadOnly)
+    UInstancedStaticMeshComponent* Instancer = nullptr;
+
+    UPROPERTY(BlueprintReadOnly)
+    int32 InstanceIndex = INDEX_NONE;
+};
+
 UCLASS()
-class CIRCLEPACKING_API APoissonSpawner : public AActor
+class CIRCLEPACKING_API APoissonSpawner : public AActor, public IGeneratorJob
 {
     GENERATED_BODY()
 
 public:
     APoissonSpawner();
 
+    UFUNCTION(BlueprintCallable, Category = "Snapshot")
+    bool SaveSnapshot() const;
+
+    UFUNCTION(BlueprintCallable, Category = "Snapshot")
+    bool LoadSnapshot();
+
+    UFUNCTION(BlueprintCallable, Category = "Replay")
+    bool SaveReplay() const;
+
+    // Clears the samples and re-places the recorded ones at the recorded pace: no candidates, no traces.
+    UFUNCTION(BlueprintCallable, Category = "Replay")
+    bool PlayReplay();
+
+    // Spatial queries over the placed samples, answered from the sampler's grid. Safe to call from any
+    // thread (e.g. async tasks); they read under a shared lock while sampling writes under an exclusive one.
+    // MaxDistance <= 0 = unlimited.
+    UFUNCTION(BlueprintCallable, Category = "Query")
+    bool FindNearestSample(const FVector& Location, float MaxDistance, FPoissonSampleHandle& OutSample) const;
+
+    // Nearest first
+    UFUNCTION(BlueprintCallable, Category = "Query")
+    TArray<FPoissonSampleHandle> FindNearestSamples(const FVector& Location, int32 Count, float MaxDistance) const;
+
+    UFUNCTION(BlueprintCallable, Category = "Query")
+    TArray<FPoissonSampleHandle> FindSamplesInRadius(const FVector& Location, float QueryRadius) const;
+
+    // Only X and Y of the box are used
+    UFUNCTION(BlueprintCallable, Category = "Query")
+    TArray<FPoissonSampleHandle> FindSamplesInBox(const FBox& Box) const;
+
+    // Game thread only: these edit the instances.
+    UFUNCTION(BlueprintCallable, Category = "Query")
+    void SetSampleHidden(const FPoissonSampleHandle& Sample, bool bHidden);
+
+    UFUNCTION(BlueprintCallable, Category = "Query")
+    void RemoveSample(const FPoissonSampleHandle& Sample);
+
+    // IGeneratorJob
+    virtual void SimulateGeneratorJob(float DeltaTime) override;
+    virtual void ApplyGeneratorJob() override;
+    virtual bool PrepareGeneratorJob(float DeltaTime) override;
+    virtual int32 GetGeneratorPriority() const override { return GeneratorPriority; }
+
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
     UPROPERTY(EditAnywhere)
     float Radius = 200.f;
@@ -30,21 +131,174 @@ protected:
     UPROPERTY(EditAnywhere)
     UMaterialInstance* MaterialInstance;
 
+    // Variable radius: spacing follows the density inputs below, between MinRadius (dense) and MaxRadius (sparse).
+    UPROPERTY(EditAnywhere, Category = "Variable Radius")
+    bool bVariableRadius = false;
+
+    UPROPERTY(EditAnywhere, Category = "Variable Radius", meta = (EditCondition = "bVariableRadius", ClampMin = "1"))
+    float MinRadius = 50.f;
+
+    UPROPERTY(EditAnywhere, Category = "Variable Radius", meta = (EditCondition = "bVariableRadius", ClampMin = "1"))
+    float MaxRadius = 400.f;
+
+    // Density in [0, 1] (bright = dense) stretched over the initial chunk square, clamped at its edges.
+    // Must be uncompressed BGRA8 or G8.
+    UPROPERTY(EditAnywhere, Category = "Variable Radius", meta = (EditCondition = "bVariableRadius"))
+    UTexture2D* DensityTexture = nullptr;
+
+    // Density in [0, 1] by distance from the actor; multiplied with the texture when both are set.
+    UPROPERTY(EditAnywhere, Category = "Variable Radius", meta = (EditCondition = "bVariableRadius"))
+    UCurveFloat* DensityCurve = nullptr;
+
+    // Minimum spacing per MeshOptions slot (missing entries = 0), e.g. trees further apart than bushes.
+    UPROPERTY(EditAnywhere, Category = "Variable Radius", meta = (EditCondition = "bVariableRadius"))
+    TArray<float> MeshMinSpacing;
+
+	// (MeshIndex, TileX, TileY) → instancer, created on first use
 	UPROPERTY()
-	TMap<UStaticMesh*, UInstancedStaticMeshComponent*> MeshToInstancer;
+	TMap<FIntVector, UInstancedStaticMeshComponent*> TileInstancers;
 
     UPROPERTY(EditAnywhere)
     TArray<UStaticMesh*> MeshOptions;
 
-    TArray<FVector2D> Samples;
-    TArray<FVector2D> ActiveList;
-    TMap<FIntPoint, FVector2D> Grid;
+    // Hierarchical instancers: per-cluster culling and LOD, tree rebuilt asynchronously after each batch of samples.
+    UPROPERTY(EditAnywhere, Category = "Rendering")
+    bool bUseHierarchicalInstancing = false;
+
+    // Split instances into square tiles of this size, one instancer per mesh and tile, so whole tiles
+    // cull and rebuild independently (0 = one instancer per mesh).
+    UPROPERTY(EditAnywhere, Category = "Rendering")
+    float TileSize = 0.f;
+
+    // Instances fade out between these distances (0 = never culled).
+    UPROPERTY(EditAnywhere, Category = "Rendering")
+    int32 InstanceStartCullDistance = 0;
+
+    UPROPERTY(EditAnywhere, Category = "Rendering")
+    int32 InstanceEndCullDistance = 0;
+
+    // 0 = new layout every play
+    UPROPERTY(EditAnywhere)
+    int32 RandomSeed = 0;
+
+    // Fill the whole chunk at once on all cores (phase-grouped grid cells) instead of growing
+    // PointsPerTick samples per tick; afterwards each tick grows the chunk and fills the new ring.
+    UPROPERTY(EditAnywhere)
+    bool bParallelFill = false;
+
+    // Drop every sample onto the ground below it. Accepted samples are traced in batches of async line traces
+    // (landscapes answer from their collision heightfield) and become instances when the hits come back,
+    // so sampling never waits on physics. Misses stay at the actor's height.
+    UPROPERTY(EditAnywhere, Category = "Ground Projection")
+    bool bProjectToGround = false;
+
+    UPROPERTY(EditAnywhere, Category = "Ground Projection", meta = (EditCondition = "bProjectToGround"))
+    TEnumAsByte<ECollisionChannel> GroundTraceChannel = ECC_WorldStatic;
+
+    // The trace runs from this far above the actor to this far below it.
+    UPROPERTY(EditAnywhere, Category = "Ground Projection", meta = (EditCondition = "bProjectToGround"))
+    float GroundTraceHeight = 10000.f;
+
+    UPROPERTY(EditAnywhere, Category = "Ground Projection", meta = (EditCondition = "bProjectToGround"))
+    float GroundTraceDepth = 10000.f;
+
+    // Tilt instances to the ground normal instead of keeping them upright.
+    UPROPERTY(EditAnywhere, Category = "Ground Projection", meta = (EditCondition = "bProjectToGround"))
+    bool bAlignToGroundNormal = true;
+
+    // Traces started per frame; the rest wait in the queue.
+    UPROPERTY(EditAnywhere, Category = "Ground Projection", meta = (EditCondition = "bProjectToGround"))
+    int32 MaxGroundTracesPerFrame = 1024;
+
+    // Let the world's generator subsystem schedule this actor (simulation on a worker task, shared frame budget)
+    // instead of ticking it.
+    UPROPERTY(EditAnywhere, Category = "Scheduling")
+    bool bUseGeneratorSubsystem = false;
+
+    UPROPERTY(EditAnywhere, Category = "Scheduling", meta = (EditCondition = "bUseGeneratorSubsystem"))
+    int32 GeneratorPriority = 0;
+
+    // Slow down or pause while far away or off-screen, and catch up once relevant again.
+    UPROPERTY(EditAnywhere, Category = "Significance")
+    FGeneratorSignificanceSettings Significance;
+
+    // Empty = Saved/Snapshots/<ActorName>.gensnap
+    UPROPERTY(EditAnywhere, Category = "Snapshot")
+    FString SnapshotPath;
+
+    // Skip the sampling and map the saved samples straight into the instances.
+    UPROPERTY(EditAnywhere, Category = "Snapshot")
+    bool bLoadSnapshotOnBeginPlay = false;
+
+    // Load at most this many records (0 = all), e.g. for a partial preview of a huge file.
+    UPROPERTY(EditAnywhere, Category = "Snapshot")
+    int32 SnapshotMaxRecords = 0;
+
+    // Record every placed sample (mesh, final transform, colour) for PlayReplay; saved on EndPlay.
+    UPROPERTY(EditAnywhere, Category = "Replay")
+    bool bRecordReplay = false;
+
+    // Empty = Saved/Replays/<ActorName>.genreplay
+    UPROPERTY(EditAnywhere, Category = "Replay")
+    FString ReplayPath;
+
+    UPROPERTY(EditAnywhere, Category = "Replay")
+    bool bPlayReplayOnBeginPlay = false;
+
+    // 1 = the recorded pace
+    UPROPERTY(EditAnywhere, Category = "Replay", meta = (ClampMin = "0"))
+    float ReplaySpeed = 1.f;
+
+    FGeneratorReplayRecorder Recorder;
+    FGeneratorReplayPlayer Player;
+    bool bReplaying = false;
+    void TickReplay(float DeltaTime);
+    // Drops every sample and instance (caller holds SamplesLock)
+    void ClearSamples();
+
+    // Bridson sampling runs in the engine-independent core; this actor turns samples into instances.
+    GenCore::FPoissonSampler Sampler;
+
+    TArray<FPoissonPlacedSample> PlacedSamples;
+    // Sampler sample index → PlacedSamples index (INDEX_NONE when no instance was made)
+    TArray<int32> SampleToPlaced;
+    // Accepted by the simulate phase, instanced by the apply phase
+    TArray<int32> NewSampleIndices;
+
+    FGeneratorThrottle Throttle;
+    // Frames' worth of simulation for this frame (see FGeneratorThrottle)
+    float SimulationScale = 1.f;
+    // Guards Sampler, PlacedSamples and SampleToPlaced for the queries
+    mutable FRWLock SamplesLock;
 
     FVector2D WorldCenter;
 
-    void AddSample(const FVector2D& Point);
-    bool IsInNeighborhood(const FVector2D& Point);
+    // MeshIndex INDEX_NONE = pick a random mesh
+    void AddSample(int32 SampleIndex, const FVector2D& Point, int32 MeshIndex = INDEX_NONE);
+    void AddSampleAt(int32 SampleIndex);
+    void PlaceSample(const FPoissonPendingSample& Sample, const FTransform& Transform);
+
+    // Ground projection: queued samples, and the ones whose trace is in flight keyed by trace user data
+    TArray<FPoissonPendingSample> PendingProjections;
+    TMap<uint32, FPoissonPendingSample> ProjectionsInFlight;
+    uint32 NextProjectionId = 0;
+    FTraceDelegate GroundTraceDelegate;
+    void DispatchGroundTraces();
+    void OnGroundTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+    // Handles for placed, not removed samples among SampleIndices (caller holds SamplesLock)
+    TArray<FPoissonSampleHandle> MakeHandles(const std::vector<int32_t>& SampleIndices) const;
+    FPoissonPlacedSample* FindPlaced(const FPoissonSampleHandle& Sample);
+    void SetupVariableRadius(GenCore::FPoissonParams& Params);
+
+    // Returns the PlacedSamples index, or INDEX_NONE
+    int32 SpawnInstance(int32 MeshIndex, const FTransform& Transform, const FLinearColor& Color);
+    UInstancedStaticMeshComponent* GetOrCreateInstancer(int32 MeshIndex, const FVector& Location);
+    void FlushInstancers();
+
+    // Instancers touched since the last flush
+    TSet<UInstancedStaticMeshComponent*> DirtyInstancers;
     void GenerateNextPoints();
+    void RunParallelFill(float InnerRadius);
 
     public:
     virtual void Tick(float DeltaTime) override;
@@ -53,7 +307,7 @@ protected:
     int32 PointsPerTick = 10;
 
     float SpawnAccumulator = 0.f;
-	UPROPERTY(EditAnywhere)
+	UPROPERTY(EditAnywhere, meta = (ClampMin = "0.001"))
 	float SpawnInterval = 0.1f;
 };
 
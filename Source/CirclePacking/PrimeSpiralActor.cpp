@@ -1,5 +1,6 @@
 ﻿#include "PrimeSpiralActor.h"
 #include "DrawDebugHelpers.h"
+#include "GeneratorSnapshotFile.h"
 
 APrimeSpiralActor::APrimeSpiralActor()
 {
@@ -27,125 +28,217 @@ void APrimeSpiralActor::BeginPlay()
 
 		Spacing = SafeSpacing;
     }
+
+    // Primes are recorded in grid units
+    if (bRecordReplay)
+        Recorder.Start(1.f);
+
+    if (bLoadSnapshotOnBeginPlay)
+        LoadSnapshot();
+    else if (bPlayReplayOnBeginPlay)
+        PlayReplay();
+
+    if (bUseGeneratorSubsystem && IsActorTickEnabled() && !bReplaying)
+        UGeneratorSubsystem::RegisterActorJob(this, this);
+}
+
+void APrimeSpiralActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    UGeneratorSubsystem::UnregisterActorJob(this, this);
+    if (Recorder.IsRecording() && Recorder.Num() > 0)
+        SaveReplay();
+    Super::EndPlay(EndPlayReason);
 }
 
 void APrimeSpiralActor::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
 
-    if (CurrentIndex > MaxPrimeCount || !PrimeMeshAsset)
+    if (bReplaying)
+    {
+        TickReplay(DeltaTime);
         return;
+    }
 
-    if (IsPrime(CurrentIndex))
+    if (!PrepareGeneratorJob(DeltaTime))
+        return;
+
+    SimulateGeneratorJob(DeltaTime);
+    ApplyGeneratorJob();
+}
+
+bool APrimeSpiralActor::PrepareGeneratorJob(float DeltaTime)
+{
+    SimulationScale = Throttle.Evaluate(this, Significance, DeltaTime);
+    if (SimulationScale <= 0.f)
+        return false;
+
+    Recorder.BeginFrame(GetWorld()->GetTimeSeconds());
+    return true;
+}
+
+void APrimeSpiralActor::SimulateGeneratorJob(float DeltaTime)
+{
+    // One index per IndexInterval of play, so frames the subsystem deferred are made up here; throttled it
+    // advances less often, catching up several at once (within GeneratorJob::MaxStepsPerRun).
+    IndexCredit += DeltaTime * SimulationScale;
+    const int32 Steps = GeneratorJob::ConsumeSteps(IndexCredit, IndexInterval);
+    for (int32 Step = 0; Step < Steps; ++Step)
+    {
+        if (CurrentIndex > MaxPrimeCount || !PrimeMeshAsset)
+            return;
+
+        if (GenCore::IsPrime(CurrentIndex))
+        {
+            PendingPrimes.Emplace(CurrentIndex, GenCore::GetUlamSpiralPosition(CurrentIndex));
+        }
+
+        ++CurrentIndex;
+    }
+}
+
+void APrimeSpiralActor::ApplyGeneratorJob()
+{
+    for (const TPair<int32, GenCore::FInt2>& Pending : PendingPrimes)
     {
-		FVector2D GridPos = GetUlamSpiralPosition(CurrentIndex);
-		float ZOffset = FMath::Sin(CurrentIndex * 0.1f) * 20.0f;
+        const int32 PrimeIndex = Pending.Key;
+		const GenCore::FInt2 GridPos = Pending.Value;
+		float ZOffset = FMath::Sin(PrimeIndex * 0.1f) * 20.0f;
 		FVector WorldPos(GridPos.X * Spacing, GridPos.Y * Spacing, 0);
 
         // Spawn instance at prime position
-        //FRotator PrimeRotation = FRotator(0, CurrentIndex % 360, 0);
-        FVector Scale = FVector(1.0f + FMath::Sin(CurrentIndex * 0.1f) * 0.5f);
-        FTransform InstanceTransform(FRotator::ZeroRotator, WorldPos);
-        InstanceTransform.SetScale3D(Scale * 0.5);
-        ISMComponent->AddInstance(InstanceTransform);
+        ISMComponent->AddInstance(GetPrimeInstanceTransform(PrimeIndex, GridPos));
+
+        if (Recorder.IsRecording())
+        {
+            GenCore::FReplayEvent Event;
+            Event.Position = GenCore::FVec3(static_cast<float>(GridPos.X), static_cast<float>(GridPos.Y), 0.f);
+            Event.Id = PrimeIndex;
+            Recorder.Record(Event);
+        }
 
         //// Draw line from last prime to this one
 		if (bHasFirstPrime)
 		{
-			FLinearColor Color = FLinearColor::LerpUsingHSV(FLinearColor::Red, FLinearColor::Blue, CurrentIndex / (float)MaxPrimeCount);
+			FLinearColor Color = FLinearColor::LerpUsingHSV(FLinearColor::Red, FLinearColor::Blue, PrimeIndex / (float)MaxPrimeCount);
 			DrawDebugLine(GetWorld(), GetActorLocation() + LastPrimeLocation + FVector(0, 0, 10), GetActorLocation() + WorldPos + FVector(0, 0, 10), Color.ToFColor(true), false, 10.f, 0, 15.0f);
 		}
 
         // === DEBUG VISUALIZATION OF SPIRAL ===
         FVector DebugWorldPos = FVector(GridPos.X * Spacing, GridPos.Y * Spacing, 50);
         DrawDebugPoint(GetWorld(), GetActorLocation() + DebugWorldPos, 10.f, FColor::Green, false, 5.f);
-        DrawDebugString(GetWorld(), GetActorLocation() + DebugWorldPos + FVector(0, 0, 25), FString::FromInt(CurrentIndex), nullptr, FColor::White, 5.f, false);
+        DrawDebugString(GetWorld(), GetActorLocation() + DebugWorldPos + FVector(0, 0, 25), FString::FromInt(PrimeIndex), nullptr, FColor::White, 5.f, false);
 
 
         //// Draw prime number above the shape
-        //DrawDebugString(GetWorld(), WorldPos + FVector(0, 0, 100), FString::FromInt(CurrentIndex), nullptr, FColor::Red, 10.f, false, 1.f);
+        //DrawDebugString(GetWorld(), WorldPos + FVector(0, 0, 100), FString::FromInt(PrimeIndex), nullptr, FColor::Red, 10.f, false, 1.f);
 
         LastPrimeLocation = WorldPos;
         bHasFirstPrime = true;
     }
+    PendingPrimes.Reset();
+}
+
+FTransform APrimeSpiralActor::GetPrimeInstanceTransform(int32 Index, const GenCore::FInt2& GridPos) const
+{
+    FVector WorldPos(GridPos.X * Spacing, GridPos.Y * Spacing, 0);
 
-    ++CurrentIndex;
+    //FRotator PrimeRotation = FRotator(0, Index % 360, 0);
+    FVector Scale = FVector(1.0f + FMath::Sin(Index * 0.1f) * 0.5f);
+    FTransform InstanceTransform(FRotator::ZeroRotator, WorldPos);
+    InstanceTransform.SetScale3D(Scale * 0.5);
+    return InstanceTransform;
 }
 
-bool APrimeSpiralActor::IsPrime(int32 Number) const
+bool APrimeSpiralActor::SaveSnapshot() const
 {
-    if (Number < 2) return false;
-    // If Number is divisible by anything bigger than its square root, it would have already been caught by a smaller factor
-    for (int32 i = 2; i * i <= Number; ++i)
+    std::vector<GenCore::FSnapshotPrime> Records;
+    for (int32 Index = 2; Index < CurrentIndex; ++Index)
     {
-        if (Number % i == 0) return false;
+        if (GenCore::IsPrime(Index))
+        {
+            const GenCore::FInt2 GridPos = GenCore::GetUlamSpiralPosition(Index);
+            Records.push_back({ Index, GridPos.X, GridPos.Y });
+        }
     }
+
+    GenCore::FSnapshotWriter Writer;
+    Writer.AddSection(Records);
+    return GeneratorSnapshot::WriteFile(GeneratorSnapshot::ResolvePath(this, SnapshotPath), Writer);
+}
+
+bool APrimeSpiralActor::LoadSnapshot()
+{
+    FGeneratorSnapshotReader Reader;
+    if (!Reader.Open(GeneratorSnapshot::ResolvePath(this, SnapshotPath)))
+        return false;
+    // A recording would not match the loaded layout
+    Recorder.Discard();
+
+    ISMComponent->ClearInstances();
+    CurrentIndex = 1;
+    bHasFirstPrime = false;
+    PendingPrimes.Reset();
+    bReplaying = false;
+    Player.Stop();
+
+    Reader.ForEachBatch<GenCore::FSnapshotPrime>(0, SnapshotMaxRecords, [this](const GenCore::FSnapshotPrime* Records, int64 Count)
+        {
+            for (int64 i = 0; i < Count; ++i)
+            {
+                const GenCore::FInt2 GridPos(Records[i].GridX, Records[i].GridY);
+                ISMComponent->AddInstance(GetPrimeInstanceTransform(Records[i].Index, GridPos));
+
+                LastPrimeLocation = FVector(GridPos.X * Spacing, GridPos.Y * Spacing, 0);
+                CurrentIndex = Records[i].Index + 1;
+                bHasFirstPrime = true;
+            }
+        });
+
+    // The spiral is deterministic, so Tick simply carries on from the next index.
     return true;
 }
 
-//17 16 15 14 13
-//18  5  4  3 12
-//19  6  1  2 11
-//20  7  8  9 10
-//21 22 23 24 25
-
-//Index 1 = center →(0, 0)
-//
-//Index 2 = right →(1, 0)
-//
-//Index 3 = up →(1, 1)
-//
-//Index 4 = left →(0, 1)
-//
-//Index 5 = left again →(−1, 1)
-//
-//Index 6 = down →(−1, 0)
-//
-//Index 7 = down again →(−1, −1)
-//
-//Index 8 = right →(0, −1)
-//
-//Index 9 = right →(1, −1)
-
-
-FVector2D APrimeSpiralActor::GetUlamSpiralPosition(int32 Index) const
+bool APrimeSpiralActor::SaveReplay() const
 {
-    //Imagine drawing numbers starting at the center, then going right, up, left, down in a square spiral.
-    //We start at the center: (0, 0)
-    int32 x = 0, y = 0;
-    //First direction: move right (dx=1, dy=0)
-    int32 dx = 1, dy = 0;
-   //We move 1 step before turning, and this indicates the steps we take before turning. Every 2 direction changes we increase segment length
-    int32 segment_length = 1;
-   //Tracking how many steps and segments we’ve done.
-    int32 segment_passed = 0;
-    int32 steps_in_segment = 0;
-
-    for (int32 i = 1; i < Index; ++i)
-    {
-        //Go from 1 to the target index, one step at a time
-        x += dx;
-        y += dy;
-        steps_in_segment++;
-        //If we've taken enough steps in this direction
-        if (steps_in_segment == segment_length)
+    return Recorder.Save(GeneratorReplay::ResolvePath(this, ReplayPath), Player);
+}
+
+bool APrimeSpiralActor::PlayReplay()
+{
+    if (!Player.Open(GeneratorReplay::ResolvePath(this, ReplayPath)))
+        return false;
+
+    // Whatever was recorded so far (e.g. the BeginPlay seeds) is not what will be on screen
+    Recorder.Discard();
+
+    UGeneratorSubsystem::UnregisterActorJob(this, this);
+    ISMComponent->ClearInstances();
+    CurrentIndex = 1;
+    bHasFirstPrime = false;
+    PendingPrimes.Reset();
+    bReplaying = true;
+    SetActorTickEnabled(true);
+    return true;
+}
+
+void APrimeSpiralActor::TickReplay(float DeltaTime)
+{
+    Player.Advance(DeltaTime, ReplaySpeed, [this](const GenCore::FReplayEvent& Event)
         {
-            //Reset step counter.
-            steps_in_segment = 0;
-            segment_passed++;
+            const GenCore::FInt2 GridPos(FMath::RoundToInt32(Event.Position.X), FMath::RoundToInt32(Event.Position.Y));
+            ISMComponent->AddInstance(GetPrimeInstanceTransform(Event.Id, GridPos));
 
-            //Turn 90° clockwise.
-            int32 temp = dx;
-            dx = -dy;
-            dy = temp;
+            LastPrimeLocation = FVector(GridPos.X * Spacing, GridPos.Y * Spacing, 0);
+            CurrentIndex = Event.Id + 1;
+            bHasFirstPrime = true;
+        });
 
-            //Every second turn, we make the next segment longer
-            if (segment_passed % 2 == 0)
-            {
-                segment_length++;
-            }
-        }
+    // Like a loaded snapshot, the spiral carries on from the next index
+    if (!Player.IsPlaying())
+    {
+        bReplaying = false;
+        if (bUseGeneratorSubsystem)
+            UGeneratorSubsystem::RegisterActorJob(this, this);
     }
-
-    return FVector2D((float)x, (float)y);
 }
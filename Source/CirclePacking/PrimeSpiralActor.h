@@ -3,20 +3,45 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "Components/InstancedStaticMeshComponent.h"
+#include "Core/PrimeSpiralCore.h"
+#include "GeneratorReplayFile.h"
+#include "GeneratorSignificance.h"
+#include "GeneratorSubsystem.h"
 #include "PrimeSpiralActor.generated.h"
 
 UCLASS()
-class CIRCLEPACKING_API APrimeSpiralActor : public AActor
+class CIRCLEPACKING_API APrimeSpiralActor : public AActor, public IGeneratorJob
 {
     GENERATED_BODY()
 
 public:
     APrimeSpiralActor();
 
+    UFUNCTION(BlueprintCallable, Category = "Snapshot")
+    bool SaveSnapshot() const;
+
+    UFUNCTION(BlueprintCallable, Category = "Snapshot")
+    bool LoadSnapshot();
+
+    UFUNCTION(BlueprintCallable, Category = "Replay")
+    bool SaveReplay() const;
+
+    // Clears the spiral and re-adds the recorded primes at the recorded pace without testing any index;
+    // the spiral then carries on after the last one.
+    UFUNCTION(BlueprintCallable, Category = "Replay")
+    bool PlayReplay();
+
 protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void Tick(float DeltaTime) override;
 
+    // IGeneratorJob
+    virtual void SimulateGeneratorJob(float DeltaTime) override;
+    virtual void ApplyGeneratorJob() override;
+    virtual bool PrepareGeneratorJob(float DeltaTime) override;
+    virtual int32 GetGeneratorPriority() const override { return GeneratorPriority; }
+
 public:
     UPROPERTY(EditAnywhere, Category = "Ulam Spiral")
     int32 MaxPrimeCount = 10000;
@@ -24,12 +49,55 @@ public:
     UPROPERTY(EditAnywhere, Category = "Ulam Spiral")
     float Spacing = 100.0f;
 
+    // Seconds of play per tested index (one per frame at 60 fps)
+    UPROPERTY(EditAnywhere, Category = "Ulam Spiral", meta = (ClampMin = "0.001"))
+    float IndexInterval = 1.f / 60.f;
+
     UPROPERTY(EditAnywhere, Category = "Ulam Spiral")
     UStaticMesh* PrimeMeshAsset;
 
     UPROPERTY(EditAnywhere, Category = "Ulam Spiral")
     UMaterialInterface* PrimeMaterial;
 
+    // Let the world's generator subsystem schedule this actor (simulation on a worker task, shared frame budget)
+    // instead of ticking it.
+    UPROPERTY(EditAnywhere, Category = "Scheduling")
+    bool bUseGeneratorSubsystem = false;
+
+    UPROPERTY(EditAnywhere, Category = "Scheduling", meta = (EditCondition = "bUseGeneratorSubsystem"))
+    int32 GeneratorPriority = 0;
+
+    // Slow down or pause while far away or off-screen, and catch up once relevant again.
+    UPROPERTY(EditAnywhere, Category = "Significance")
+    FGeneratorSignificanceSettings Significance;
+
+    // Empty = Saved/Snapshots/<ActorName>.gensnap
+    UPROPERTY(EditAnywhere, Category = "Snapshot")
+    FString SnapshotPath;
+
+    // Map the saved primes straight into the instances and continue the spiral after the last one.
+    UPROPERTY(EditAnywhere, Category = "Snapshot")
+    bool bLoadSnapshotOnBeginPlay = false;
+
+    // Load at most this many primes (0 = all).
+    UPROPERTY(EditAnywhere, Category = "Snapshot")
+    int32 SnapshotMaxRecords = 0;
+
+    // Record every prime as it is placed for PlayReplay; saved on EndPlay.
+    UPROPERTY(EditAnywhere, Category = "Replay")
+    bool bRecordReplay = false;
+
+    // Empty = Saved/Replays/<ActorName>.genreplay
+    UPROPERTY(EditAnywhere, Category = "Replay")
+    FString ReplayPath;
+
+    UPROPERTY(EditAnywhere, Category = "Replay")
+    bool bPlayReplayOnBeginPlay = false;
+
+    // 1 = the recorded pace
+    UPROPERTY(EditAnywhere, Category = "Replay", meta = (ClampMin = "0"))
+    float ReplaySpeed = 1.f;
+
 private:
     UPROPERTY(EditAnywhere)
     UInstancedStaticMeshComponent* ISMComponent;
@@ -38,6 +106,19 @@ private:
     FVector LastPrimeLocation = FVector::ZeroVector;
     bool bHasFirstPrime = false;
 
-    bool IsPrime(int32 Number) const;
-    FVector2D GetUlamSpiralPosition(int32 Index) const;
+    // Found by the simulate phase (index, spiral position), drawn by the apply phase
+    TArray<TPair<int32, GenCore::FInt2>> PendingPrimes;
+
+    FGeneratorThrottle Throttle;
+    // Frames' worth of simulation for this frame (see FGeneratorThrottle)
+    float SimulationScale = 1.f;
+    // Seconds owed; whole indices are tested, the fraction carries over
+    float IndexCredit = 0.f;
+
+    FTransform GetPrimeInstanceTransform(int32 Index, const GenCore::FInt2& GridPos) const;
+
+    FGeneratorReplayRecorder Recorder;
+    FGeneratorReplayPlayer Player;
+    bool bReplaying = false;
+    void TickReplay(float DeltaTime);
 };
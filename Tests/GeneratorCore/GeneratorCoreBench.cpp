@@ -0,0 +1,298 @@
+// Microbenchmarks for the engine-independent generator core.
+
+#include "CirclePackingCore.h"
+#include "DLACore.h"
+#include "GenReplay.h"
+#include "PoissonCore.h"
+#include "PrimeSpiralCore.h"
+#include "VoxelMesher.h"
+#include "HarnessCommon.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+namespace
+{
+    using namespace GenCore;
+    using FClock = std::chrono::steady_clock;
+
+    // Keeps results alive so the optimizer cannot drop the measured work.
+    volatile int64_t Sink = 0;
+
+    template <typename FnType>
+    void Run(const char* Name, int64_t Items, const char* ItemName, FnType&& Fn)
+    {
+        const FClock::time_point Start = FClock::now();
+        Fn();
+        const double Seconds = std::chrono::duration<double>(FClock::now() - Start).count();
+        std::printf("%-34s %10.2f ms  %12.0f %s/s\n", Name, Seconds * 1000.0, Items / Seconds, ItemName);
+    }
+
+    void BenchCirclePacking()
+    {
+        const int32_t Spawns = 3000;
+        Run("CirclePacking/TrySpawn x3000", Spawns, "tries", []()
+            {
+                FCirclePacker Packer;
+                Packer.Reset(FCirclePackingParams(), 1);
+                for (int32_t i = 0; i < Spawns; ++i)
+                {
+                    Packer.TrySpawnNewCircle();
+                }
+                Sink += static_cast<int64_t>(Packer.GetCircles().size());
+            });
+
+        FCirclePackingParams Params;
+        Params.Mode = ECirclePackingMode::FrontChain;
+        Params.MinTargetRadius = 2.f;
+        Params.MaxTargetRadius = 60.f;
+        Params.ExponentBias = 0.2f;
+        FCirclePacker Packer;
+        Run("CirclePacking/FrontChain fill", 1, "fills", [&]()
+            {
+                Packer.Reset(Params, 1);
+                while (Packer.TrySpawnNewCircle() >= 0)
+                {
+                }
+            });
+        std::printf("%-34s %10zu circles\n", "", Packer.GetCircles().size());
+
+        // Spawn + grow steps; each step only tests the circles still growing
+        Params.Mode = ECirclePackingMode::GrowUntilContact;
+        Params.GrowthRate = 40.f;
+        const int32_t Steps = 20000;
+        Run("CirclePacking/GrowUntilContact x2e4", Steps, "steps", [&]()
+            {
+                Packer.Reset(Params, 1);
+                for (int32_t i = 0; i < Steps; ++i)
+                {
+                    Packer.TrySpawnNewCircle();
+                    Packer.Advance(0.1f);
+                }
+            });
+        std::printf("%-34s %10zu circles, %d growing\n", "", Packer.GetCircles().size(), Packer.GetGrowingCount());
+
+        // Outlined text-like mask: sparse strokes a few texels wide
+        const int32_t Size = 1024;
+        std::vector<float> Weights(Size * Size, 0.f);
+        for (int32_t Y = 0; Y < Size; ++Y)
+        {
+            for (int32_t X = 0; X < Size; ++X)
+            {
+                Weights[Y * Size + X] = (X % 128 < 6 || Y % 96 < 4) ? 1.f : 0.f;
+            }
+        }
+        auto Mask = std::make_shared<FCirclePackingMask>();
+        Run("CirclePacking/Mask build 1024^2", static_cast<int64_t>(Size) * Size, "texels", [&]()
+            {
+                Mask->Build(Weights, Size, Size);
+            });
+
+        Params.Mode = ECirclePackingMode::Random;
+        Params.Mask = Mask;
+        Params.MaxAttempts = 1;
+        int32_t Accepted = 0;
+        Run("CirclePacking/Masked darts x2e4", Steps, "tries", [&]()
+            {
+                Packer.Reset(Params, 1);
+                for (int32_t i = 0; i < Steps; ++i)
+                {
+                    Accepted += Packer.TrySpawnNewCircle() >= 0 ? 1 : 0;
+                }
+            });
+        std::printf("%-34s %10d accepted\n", "", Accepted);
+    }
+
+    void BenchPoisson()
+    {
+        FPoissonParams Params;
+        Params.Radius = 20.f;
+        Params.ChunkSize = 4000.f;
+
+        FPoissonSampler Sampler;
+        Run("Poisson/Fill r=20 chunk=4000", 1, "fills", [&]()
+            {
+                Sampler.Reset(Params, 1);
+                Sampler.AddSeed(FVec2(0.f, 0.f));
+                while (Sampler.GetActiveCount() > 0)
+                {
+                    Sampler.GenerateNextPoint();
+                }
+            });
+        std::printf("%-34s %10zu samples\n", "", Sampler.GetSamples().size());
+
+        FPoissonParams Variable = Params;
+        Variable.MinRadius = 20.f;
+        Variable.MaxRadius = 320.f;
+        Variable.RadiusAt = [](float X, float Y) { return X < 0.f && Y < 0.f ? 320.f : 20.f; };
+        Variable.MeshMinSpacing = { 0.f, 0.f, 40.f };
+        Run("Poisson/Fill variable r=20..320", 1, "fills", [&]()
+            {
+                Sampler.Reset(Variable, 1);
+                Sampler.AddSeed(FVec2(0.f, 0.f));
+                while (Sampler.GetActiveCount() > 0)
+                {
+                    Sampler.GenerateNextPoint();
+                }
+            });
+        std::printf("%-34s %10zu samples\n", "", Sampler.GetSamples().size());
+
+        Sampler.Reset(Params, 1);
+        Sampler.GenerateParallel(SerialFor);
+        const int32_t Queries = 100000;
+        Run("Poisson/QueryNearest k=8 x1e5", Queries, "queries", [&]()
+            {
+                FGenRandom Random(2);
+                std::vector<int32_t> Found;
+                for (int32_t i = 0; i < Queries; ++i)
+                {
+                    // Gameplay asks from inside the scattered area
+                    const float Angle = Random.FRandRange(0.f, 2.f * GenPi);
+                    const float Distance = Random.FRandRange(0.f, Params.ChunkSize);
+                    Found.clear();
+                    Sampler.QueryNearest(FVec2(std::cos(Angle), std::sin(Angle)) * Distance, 8, Found);
+                    Sink += Found[0];
+                }
+            });
+
+        Run("Poisson/ParallelFill serial", 1, "fills", [&]()
+            {
+                Sampler.Reset(Params, 1);
+                Sampler.GenerateParallel(SerialFor);
+            });
+        std::printf("%-34s %10zu samples\n", "", Sampler.GetSamples().size());
+
+        Run("Poisson/ParallelFill threaded", 1, "fills", [&]()
+            {
+                Sampler.Reset(Params, 1);
+                Sampler.GenerateParallel(GenHarness::ThreadedFor);
+            });
+
+        // Each refill visits only the new 200-wide ring: its cost follows the ring's area, not the chunk's
+        const int32_t Rings = 20;
+        Run("Poisson/ParallelFill ring x20", Rings, "rings", [&]()
+            {
+                for (int32_t i = 0; i < Rings; ++i)
+                {
+                    const float InnerRadius = Sampler.GetChunkSize();
+                    Sampler.Reseed(200.f, 0);
+                    Sampler.GenerateParallel(GenHarness::ThreadedFor, InnerRadius);
+                }
+            });
+        std::printf("%-34s %10zu samples\n", "", Sampler.GetSamples().size());
+    }
+
+    void BenchDLA(const char* Name, const FParallelForFn& ParallelFor, int32_t Walkers = 20000, int32_t Steps = 200)
+    {
+        FDLAParams Params;
+        Params.MaxWalkers = Walkers;
+        Params.Bounds = 40;
+
+        FDLASimulation Simulation;
+        Simulation.Reset(Params, 1);
+        std::vector<FInt3> Stuck;
+        Run(Name, static_cast<int64_t>(Params.MaxWalkers) * Steps, "walker-steps", [&]()
+            {
+                for (int32_t i = 0; i < Steps; ++i)
+                {
+                    Simulation.Step(ParallelFor, Stuck);
+                }
+            });
+        Sink += static_cast<int64_t>(Stuck.size());
+    }
+
+    void BenchGreedyMesh()
+    {
+        // Porous ball: about the voxel count of a large finished cluster
+        std::vector<FInt3> Voxels;
+        FGenRandom Random(3);
+        for (int32_t X = -40; X <= 40; ++X)
+            for (int32_t Y = -40; Y <= 40; ++Y)
+                for (int32_t Z = -40; Z <= 40; ++Z)
+                    if (X * X + Y * Y + Z * Z <= 1600 && Random.FRand() < 0.7f) Voxels.push_back(FInt3(X, Y, Z));
+
+        std::vector<FVoxelQuad> Quads;
+        Run("VoxelMesher/Greedy ball r=40", static_cast<int64_t>(Voxels.size()), "voxels", [&]()
+            {
+                GreedyMeshVoxels(Voxels, {}, Quads);
+            });
+        std::printf("%-34s %10zu voxels → %zu quads\n", "", Voxels.size(), Quads.size());
+    }
+
+    void BenchReplay()
+    {
+        // Branch-like walk of 1e5 voxels, about 25 sticking per frame, recorded in grid units like the DLA actor
+        FReplayWriter Writer;
+        Writer.Reset(1.f);
+        FGenRandom Random(4);
+        FInt3 Voxel(0, 0, 0);
+        const int32_t Events = 100000;
+        Run("Replay/Encode 1e5 voxels", Events, "events", [&]()
+            {
+                for (int32_t i = 0; i < Events; ++i)
+                {
+                    Voxel.X += Random.RandRange(-1, 1);
+                    Voxel.Y += Random.RandRange(-1, 1);
+                    Voxel.Z += Random.RandRange(-1, 1);
+                    FReplayEvent Event;
+                    Event.Type = EReplayEventType::Stick;
+                    Event.Frame = static_cast<uint32_t>(i / 25);
+                    Event.Time = Event.Frame / 60.0;
+                    Event.Position = FVec3(static_cast<float>(Voxel.X), static_cast<float>(Voxel.Y), static_cast<float>(Voxel.Z));
+                    Writer.Add(Event);
+                }
+            });
+        const std::vector<uint8_t> Image = Writer.Finalize();
+        std::printf("%-34s %10u events, %.2f bytes/event\n", "", Writer.GetEventCount(),
+            static_cast<double>(Writer.GetPayloadSize()) / std::max<uint32_t>(Writer.GetEventCount(), 1));
+
+        const int32_t Passes = 20;
+        Run("Replay/Decode 1e5 x20", static_cast<int64_t>(Writer.GetEventCount()) * Passes, "events", [&]()
+            {
+                FReplayReader Reader;
+                FReplayEvent Event;
+                for (int32_t i = 0; i < Passes; ++i)
+                {
+                    Reader.Open(Image.data(), Image.size());
+                    while (Reader.Next(Event))
+                    {
+                        Sink += Event.Frame;
+                    }
+                }
+            });
+    }
+
+    void BenchPrimeSpiral()
+    {
+        const int32_t Count = 1000000;
+        Run("PrimeSpiral/IsPrime+Ulam x1e6", Count, "indices", []()
+            {
+                int64_t Acc = 0;
+                for (int32_t i = 1; i <= Count; ++i)
+                {
+                    if (IsPrime(i))
+                    {
+                        const FInt2 Pos = GetUlamSpiralPosition(i);
+                        Acc += Pos.X ^ Pos.Y;
+                    }
+                }
+                Sink += Acc;
+            });
+    }
+}
+
+int main()
+{
+    BenchCirclePacking();
+    BenchPoisson();
+    BenchDLA("DLA/Step 20k walkers serial", SerialFor);
+    BenchDLA("DLA/Step 20k walkers threaded", GenHarness::ThreadedFor);
+    BenchDLA("DLA/Step 1M walkers threaded", GenHarness::ThreadedFor, 1000000, 20);
+    BenchGreedyMesh();
+    BenchReplay();
+    BenchPrimeSpiral();
+    return 0;
+}
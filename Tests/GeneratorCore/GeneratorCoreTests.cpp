@@ -0,0 +1,952 @@
+// Correctness tests for the engine-independent generator core.
+
+#include "CirclePackingCore.h"
+#include "DLACore.h"
+#include "GenReplay.h"
+#include "GenSnapshot.h"
+#include "PoissonCore.h"
+#include "PrimeSpiralCore.h"
+#include "VoxelMesher.h"
+#include "HarnessCommon.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <set>
+#include <tuple>
+
+namespace
+{
+    int32_t Failures = 0;
+
+#define GEN_EXPECT(Cond) \
+    do { if (!(Cond)) { std::printf("  FAILED %s:%d: %s\n", __FILE__, __LINE__, #Cond); ++Failures; } } while (0)
+
+    using namespace GenCore;
+
+    void TestCirclePackingNoOverlap()
+    {
+        FCirclePackingParams Params;
+        Params.CanvasSize = 1000.f;
+        FCirclePacker Packer;
+        Packer.Reset(Params, 42);
+
+        for (int32_t i = 0; i < 400; ++i)
+        {
+            Packer.TrySpawnNewCircle();
+        }
+
+        const std::vector<FCircle>& Circles = Packer.GetCircles();
+        GEN_EXPECT(Circles.size() > 50);
+        for (size_t i = 0; i < Circles.size(); ++i)
+        {
+            GEN_EXPECT(Circles[i].TargetRadius >= Params.MinTargetRadius && Circles[i].TargetRadius <= Params.MaxTargetRadius);
+            GEN_EXPECT(std::fabs(Circles[i].Position.X) <= Params.CanvasSize && std::fabs(Circles[i].Position.Y) <= Params.CanvasSize);
+            for (size_t j = i + 1; j < Circles.size(); ++j)
+            {
+                const float MinDist = Circles[i].TargetRadius + Circles[j].TargetRadius;
+                GEN_EXPECT(FVec2::DistSquared(Circles[i].Position, Circles[j].Position) >= MinDist * MinDist);
+            }
+        }
+    }
+
+    // Fraction of grid points in the inner half of the canvas covered by a reserved disc
+    float InnerCoverage(const FCirclePacker& Packer)
+    {
+        const float Half = Packer.GetParams().CanvasSize * 0.5f;
+        int32_t Covered = 0;
+        const int32_t Steps = 100;
+        for (int32_t i = 0; i < Steps; ++i)
+        {
+            for (int32_t j = 0; j < Steps; ++j)
+            {
+                const FVec2 Point(-Half + 2.f * Half * (i + 0.5f) / Steps, -Half + 2.f * Half * (j + 0.5f) / Steps);
+                for (const FCircle& Circle : Packer.GetCircles())
+                {
+                    if (FVec2::DistSquared(Point, Circle.Position) <= Circle.TargetRadius * Circle.TargetRadius)
+                    {
+                        ++Covered;
+                        break;
+                    }
+                }
+            }
+        }
+        return static_cast<float>(Covered) / (Steps * Steps);
+    }
+
+    void TestCirclePackingFrontChain()
+    {
+        FCirclePackingParams Params;
+        Params.Mode = ECirclePackingMode::FrontChain;
+        Params.CanvasSize = 400.f;
+        Params.MinTargetRadius = 4.f;
+        Params.MaxTargetRadius = 40.f;
+        Params.ExponentBias = 0.1f;
+
+        FCirclePacker Packer;
+        FCirclePacker Again;
+        Packer.Reset(Params, 3);
+        Again.Reset(Params, 3);
+        int32_t Spawned = 0;
+        while (Spawned < 100000 && Packer.TrySpawnNewCircle() == Spawned)
+        {
+            GEN_EXPECT(Again.TrySpawnNewCircle() == Spawned);
+            ++Spawned;
+        }
+        GEN_EXPECT(Spawned < 100000);
+
+        const std::vector<FCircle>& Circles = Packer.GetCircles();
+        for (size_t i = 0; i < Circles.size(); ++i)
+        {
+            GEN_EXPECT(Circles[i].Position.X == Again.GetCircles()[i].Position.X && Circles[i].Position.Y == Again.GetCircles()[i].Position.Y);
+            GEN_EXPECT(Circles[i].TargetRadius >= Params.MinTargetRadius && Circles[i].TargetRadius <= Params.MaxTargetRadius);
+            GEN_EXPECT(std::fabs(Circles[i].Position.X) <= Params.CanvasSize && std::fabs(Circles[i].Position.Y) <= Params.CanvasSize);
+            for (size_t j = i + 1; j < Circles.size(); ++j)
+            {
+                const float MinDist = (Circles[i].TargetRadius + Circles[j].TargetRadius) * 0.999f;
+                GEN_EXPECT(FVec2::DistSquared(Circles[i].Position, Circles[j].Position) >= MinDist * MinDist);
+            }
+        }
+
+        // Denser than random darts given the same number of circles' worth of tries
+        Params.Mode = ECirclePackingMode::Random;
+        FCirclePacker Darts;
+        Darts.Reset(Params, 3);
+        for (int32_t i = 0; i < Spawned; ++i)
+        {
+            Darts.TrySpawnNewCircle();
+        }
+        const float FrontCoverage = InnerCoverage(Packer);
+        GEN_EXPECT(FrontCoverage > 0.75f);
+        GEN_EXPECT(FrontCoverage > InnerCoverage(Darts));
+    }
+
+    void TestCirclePackingGrowUntilContact()
+    {
+        FCirclePackingParams Params;
+        Params.Mode = ECirclePackingMode::GrowUntilContact;
+        Params.CanvasSize = 500.f;
+        Params.MinTargetRadius = 2.f;
+        Params.MaxTargetRadius = 120.f;
+        Params.ExponentBias = 0.03f;
+        Params.GrowthRate = 40.f;
+        Params.MaxAttempts = 10;
+
+        FCirclePacker Packer;
+        Packer.Reset(Params, 11);
+        int32_t SettledCount = 0;
+        for (int32_t Step = 0; Step < 1400 && (Step < 1000 || Packer.GetGrowingCount() > 0); ++Step)
+        {
+            if (Step < 1000)
+                Packer.TrySpawnNewCircle();
+            Packer.Advance(0.1f);
+            // Settled circles are reported once, with their final size
+            for (const int32_t Index : Packer.GetSettled())
+            {
+                GEN_EXPECT(Packer.GetCircles()[Index].Radius == Packer.GetCircles()[Index].TargetRadius);
+            }
+            SettledCount += static_cast<int32_t>(Packer.GetSettled().size());
+        }
+        GEN_EXPECT(Packer.GetGrowingCount() == 0);
+
+        // Nobody overlaps, and circles stopped by a neighbour are touching it
+        const std::vector<FCircle>& Circles = Packer.GetCircles();
+        int32_t Touching = 0;
+        for (size_t i = 0; i < Circles.size(); ++i)
+        {
+            GEN_EXPECT(Circles[i].Radius == Circles[i].TargetRadius);
+            for (size_t j = i + 1; j < Circles.size(); ++j)
+            {
+                const float Dist = FVec2::Distance(Circles[i].Position, Circles[j].Position);
+                const float Sum = Circles[i].Radius + Circles[j].Radius;
+                GEN_EXPECT(Dist >= Sum * 0.999f);
+                Touching += Dist < Sum * 1.001f ? 1 : 0;
+            }
+        }
+        GEN_EXPECT(Touching > 50);
+        GEN_EXPECT(SettledCount > 0 && SettledCount <= static_cast<int32_t>(Circles.size()));
+
+        // Without reservations, the same number of tries fits more circles than random darts
+        Params.Mode = ECirclePackingMode::Random;
+        FCirclePacker Darts;
+        Darts.Reset(Params, 11);
+        for (int32_t Step = 0; Step < 1000; ++Step)
+        {
+            Darts.TrySpawnNewCircle();
+        }
+        GEN_EXPECT(Circles.size() > Darts.GetCircles().size());
+    }
+
+    void TestCirclePackingMaskSampling()
+    {
+        // Left half 0.25, right half 0.75, an empty column band between them and random holes
+        const int32_t Width = 64;
+        const int32_t Height = 40;
+        std::vector<float> Weights(Width * Height);
+        FGenRandom Random(5);
+        for (int32_t Y = 0; Y < Height; ++Y)
+        {
+            for (int32_t X = 0; X < Width; ++X)
+            {
+                const bool bHole = (X >= 30 && X < 34) || Random.FRand() < 0.2f;
+                Weights[Y * Width + X] = bHole ? 0.f : (X < 32 ? 0.25f : 0.75f);
+            }
+        }
+
+        FCirclePackingMask Mask;
+        Mask.Build(Weights, Width, Height);
+        GEN_EXPECT(!Mask.IsEmpty());
+
+        int32_t Right = 0;
+        const int32_t Draws = 20000;
+        for (int32_t i = 0; i < Draws; ++i)
+        {
+            FVec2 Texel;
+            GEN_EXPECT(Mask.Sample(Random, Texel));
+            GEN_EXPECT(Mask.GetWeight(Texel) > 0.f);
+            Right += Texel.X >= 32.f ? 1 : 0;
+        }
+        GEN_EXPECT(std::fabs(static_cast<float>(Right) / Draws - 0.75f) < 0.02f);
+
+        // Edge distance matches a brute force search over the outside texels (the image border counts as outside)
+        for (int32_t Y = 0; Y < Height; ++Y)
+        {
+            for (int32_t X = 0; X < Width; ++X)
+            {
+                float Nearest = std::numeric_limits<float>::max();
+                for (int32_t OY = -1; OY <= Height; ++OY)
+                {
+                    for (int32_t OX = -1; OX <= Width; ++OX)
+                    {
+                        const bool bOutside = OX < 0 || OY < 0 || OX >= Width || OY >= Height || Weights[OY * Width + OX] <= 0.f;
+                        if (bOutside)
+                            Nearest = std::min(Nearest, FVec2::Distance(FVec2(X, Y), FVec2(OX, OY)));
+                    }
+                }
+                const float Expected = Weights[Y * Width + X] > 0.f ? Nearest - 0.70710678f : 0.f;
+                GEN_EXPECT(std::fabs(Mask.GetEdgeDistance(FVec2(X + 0.5f, Y + 0.5f)) - Expected) < 1e-3f);
+            }
+        }
+
+        // Non-square, non-power-of-two: draws stay inside the 3x5 image, never in the pyramid's zero padding
+        FCirclePackingMask Small;
+        Small.Build({ 1e-7f, 0.f, 0.3f, 0.f, 1.f, 0.f, 0.7f, 0.f, 1e-6f, 0.f, 0.f, 0.f, 0.1f, 0.f, 1e-7f }, 3, 5);
+        for (int32_t i = 0; i < 200000; ++i)
+        {
+            FVec2 Texel;
+            GEN_EXPECT(Small.Sample(Random, Texel));
+            GEN_EXPECT(Texel.X >= 0.f && Texel.X < 3.f && Texel.Y >= 0.f && Texel.Y < 5.f);
+            GEN_EXPECT(Small.GetWeight(Texel) > 0.f);
+        }
+
+        FCirclePackingMask Empty;
+        Empty.Build(std::vector<float>(16, 0.f), 4, 4);
+        FVec2 Texel;
+        GEN_EXPECT(Empty.IsEmpty() && !Empty.Sample(Random, Texel));
+    }
+
+    void TestCirclePackingMasked()
+    {
+        // Thin ring, three texels wide
+        const int32_t Size = 128;
+        std::vector<float> Weights(Size * Size, 0.f);
+        for (int32_t Y = 0; Y < Size; ++Y)
+        {
+            for (int32_t X = 0; X < Size; ++X)
+            {
+                const float Dist = FVec2::Distance(FVec2(X + 0.5f, Y + 0.5f), FVec2(64.f, 64.f));
+                Weights[Y * Size + X] = Dist >= 40.f && Dist < 43.f ? 1.f : 0.f;
+            }
+        }
+        auto Mask = std::make_shared<FCirclePackingMask>();
+        Mask->Build(Weights, Size, Size);
+
+        for (const ECirclePackingMode Mode : { ECirclePackingMode::Random, ECirclePackingMode::GrowUntilContact })
+        {
+            FCirclePackingParams Params;
+            Params.Mode = Mode;
+            Params.CanvasSize = 640.f;
+            Params.MinTargetRadius = 2.f;
+            Params.MaxAttempts = 1;
+            Params.Mask = Mask;
+
+            // Single-attempt spawns nearly always land while the ring is still empty
+            FCirclePacker Packer;
+            Packer.Reset(Params, 8);
+            int32_t Accepted = 0;
+            for (int32_t i = 0; i < 50; ++i)
+            {
+                Accepted += Packer.TrySpawnNewCircle() >= 0 ? 1 : 0;
+                Packer.Advance(0.1f);
+            }
+            GEN_EXPECT(Accepted >= 40);
+
+            // Every circle lies inside the ring (texels are 10 units)
+            for (const FCircle& Circle : Packer.GetCircles())
+            {
+                GEN_EXPECT(Circle.TargetRadius > 0.f && Circle.TargetRadius <= 15.f);
+                for (int32_t Side = 0; Side < 8; ++Side)
+                {
+                    const float Angle = Side * GenPi / 4.f;
+                    const FVec2 Edge = Circle.Position + FVec2(std::cos(Angle), std::sin(Angle)) * (Circle.TargetRadius * 0.99f);
+                    GEN_EXPECT(Mask->GetWeight(Edge * 0.1f + FVec2(64.f, 64.f)) > 0.f);
+                }
+            }
+        }
+    }
+
+    void TestCirclePackingGrowth()
+    {
+        FCirclePacker Packer;
+        Packer.Reset(FCirclePackingParams(), 7);
+        GEN_EXPECT(Packer.TrySpawnNewCircle() == 0);
+
+        Packer.Advance(0.1f);
+        const FCircle& Circle = Packer.GetCircles()[0];
+        GEN_EXPECT(std::fabs(Circle.Radius - std::min(2.f, Circle.TargetRadius)) < 1e-4f);
+
+        for (int32_t i = 0; i < 1000; ++i)
+        {
+            Packer.Advance(0.1f);
+        }
+        GEN_EXPECT(Packer.GetCircles()[0].Radius == Packer.GetCircles()[0].TargetRadius);
+        GEN_EXPECT(std::fabs(Packer.GetAge(Packer.GetCircles()[0]) - 100.1f) < 1e-2f);
+        GEN_EXPECT(FCirclePacker::ComputeEmissive(Packer.GetCircles()[0], Packer.GetAge(Packer.GetCircles()[0])) == 0.f);
+    }
+
+    void TestPoissonMinDistance()
+    {
+        FPoissonParams Params;
+        Params.Radius = 50.f;
+        Params.ChunkSize = 1500.f;
+        FPoissonSampler Sampler;
+        Sampler.Reset(Params, 1234);
+        Sampler.AddSeed(FVec2(0.f, 0.f));
+
+        while (Sampler.GetActiveCount() > 0)
+        {
+            Sampler.GenerateNextPoint();
+        }
+
+        const std::vector<FVec2>& Samples = Sampler.GetSamples();
+        GEN_EXPECT(Samples.size() > 500);
+        for (size_t i = 0; i < Samples.size(); ++i)
+        {
+            GEN_EXPECT(FVec2::Distance(Samples[i], Params.Center) <= Params.ChunkSize + 1e-3f);
+            for (size_t j = i + 1; j < Samples.size(); ++j)
+            {
+                GEN_EXPECT(FVec2::Distance(Samples[i], Samples[j]) >= Params.Radius);
+            }
+        }
+    }
+
+    void ExpectMinDistance(const std::vector<FVec2>& Samples, float Radius)
+    {
+        int32_t Violations = 0;
+        for (size_t i = 0; i < Samples.size(); ++i)
+        {
+            for (size_t j = i + 1; j < Samples.size(); ++j)
+            {
+                Violations += FVec2::Distance(Samples[i], Samples[j]) < Radius ? 1 : 0;
+            }
+        }
+        GEN_EXPECT(Violations == 0);
+    }
+
+    void TestPoissonParallelMinDistance()
+    {
+        FPoissonParams Params;
+        Params.Radius = 30.f;
+        Params.ChunkSize = 800.f;
+        Params.Center = FVec2(120.f, -45.f);
+
+        FPoissonSampler Threaded;
+        Threaded.Reset(Params, 77);
+        // Seeds placed beforehand (even just outside the chunk) must be respected
+        Threaded.AddSeed(Params.Center);
+        Threaded.AddSeed(Params.Center + FVec2(Params.ChunkSize + 10.f, 0.f));
+        Threaded.GenerateParallel(GenHarness::ThreadedFor);
+
+        const std::vector<FVec2>& Samples = Threaded.GetSamples();
+        GEN_EXPECT(Samples.size() > 1200);
+        ExpectMinDistance(Samples, Params.Radius);
+
+        // Grow the chunk and fill only the ring
+        Threaded.Reseed(300.f, 0);
+        const size_t Before = Samples.size();
+        Threaded.GenerateParallel(GenHarness::ThreadedFor, Params.ChunkSize);
+        GEN_EXPECT(Samples.size() > Before + 500);
+        ExpectMinDistance(Samples, Params.Radius);
+        for (size_t i = 2; i < Samples.size(); ++i)
+        {
+            GEN_EXPECT(FVec2::Distance(Samples[i], Params.Center) <= Params.ChunkSize + 300.f + 1e-3f);
+        }
+
+        // Same seed, same samples, regardless of threading
+        FPoissonSampler Serial;
+        Serial.Reset(Params, 77);
+        Serial.AddSeed(Params.Center);
+        Serial.AddSeed(Params.Center + FVec2(Params.ChunkSize + 10.f, 0.f));
+        Serial.GenerateParallel(SerialFor);
+        GEN_EXPECT(Serial.GetSamples().size() == Before && std::equal(Serial.GetSamples().begin(), Serial.GetSamples().end(), Samples.begin(),
+            [](const FVec2& A, const FVec2& B) { return A.X == B.X && A.Y == B.Y; }));
+
+        // The incremental sampler sees the parallel samples through the shared grid
+        for (const FVec2& Sample : Samples)
+        {
+            GEN_EXPECT(Threaded.IsInNeighborhood(Sample + FVec2(1.f, 0.f)));
+        }
+    }
+
+    void TestPoissonVariableRadius()
+    {
+        FPoissonParams Params;
+        Params.ChunkSize = 1500.f;
+        Params.MinRadius = 10.f;
+        Params.MaxRadius = 160.f;
+        // Dense in the middle, sparse towards the rim: a 16x radius ratio
+        Params.RadiusAt = [](float X, float Y) { return 10.f + 150.f * std::min(1.f, std::sqrt(X * X + Y * Y) / 1500.f); };
+        // Mesh 1 never sits closer than 60 to anything
+        Params.MeshMinSpacing = { 0.f, 60.f };
+
+        FPoissonSampler Sampler;
+        Sampler.Reset(Params, 3);
+        Sampler.AddSeed(FVec2(0.f, 0.f));
+        while (Sampler.GetActiveCount() > 0)
+        {
+            Sampler.GenerateNextPoint();
+        }
+
+        const std::vector<FVec2>& Samples = Sampler.GetSamples();
+        GEN_EXPECT(Samples.size() > 400);
+
+        int32_t Violations = 0;
+        int32_t SmallSamples = 0;
+        int32_t MeshOne = 0;
+        for (int32_t i = 0; i < static_cast<int32_t>(Samples.size()); ++i)
+        {
+            const float RadiusI = Sampler.GetSampleRadius(i);
+            GEN_EXPECT(RadiusI >= Params.MinRadius && RadiusI <= Params.MaxRadius);
+            GEN_EXPECT(Sampler.GetSampleMesh(i) == 0 || Sampler.GetSampleMesh(i) == 1);
+            GEN_EXPECT(Sampler.GetSampleMesh(i) != 1 || RadiusI >= 60.f);
+            SmallSamples += RadiusI < 20.f ? 1 : 0;
+            MeshOne += Sampler.GetSampleMesh(i) == 1 ? 1 : 0;
+            for (int32_t j = i + 1; j < static_cast<int32_t>(Samples.size()); ++j)
+            {
+                const float MinDist = std::max(RadiusI, Sampler.GetSampleRadius(j));
+                Violations += FVec2::Distance(Samples[i], Samples[j]) < MinDist ? 1 : 0;
+            }
+        }
+        GEN_EXPECT(Violations == 0);
+        GEN_EXPECT(SmallSamples > 0);
+        GEN_EXPECT(MeshOne > 50);
+    }
+
+    // Compares every query against a brute-force scan of the samples.
+    void ExpectQueriesMatchScan(const FPoissonSampler& Sampler)
+    {
+        const std::vector<FVec2>& Samples = Sampler.GetSamples();
+        FGenRandom Random(9);
+        for (int32_t Query = 0; Query < 50; ++Query)
+        {
+            const FVec2 Point(Random.FRandRange(-1800.f, 1800.f), Random.FRandRange(-1800.f, 1800.f));
+            const float Reach = Random.FRandRange(0.f, 600.f);
+
+            std::vector<int32_t> Expected;
+            for (int32_t i = 0; i < static_cast<int32_t>(Samples.size()); ++i)
+            {
+                if (FVec2::DistSquared(Samples[i], Point) <= Reach * Reach) Expected.push_back(i);
+            }
+            std::vector<int32_t> Found;
+            Sampler.QueryRadius(Point, Reach, Found);
+            std::sort(Found.begin(), Found.end());
+            GEN_EXPECT(Found == Expected);
+
+            const FVec2 Min = Point - FVec2(Reach, Reach * 0.5f);
+            const FVec2 Max = Point + FVec2(Reach, Reach * 0.5f);
+            Expected.clear();
+            for (int32_t i = 0; i < static_cast<int32_t>(Samples.size()); ++i)
+            {
+                const FVec2& P = Samples[i];
+                if (P.X >= Min.X && P.X <= Max.X && P.Y >= Min.Y && P.Y <= Max.Y) Expected.push_back(i);
+            }
+            Found.clear();
+            Sampler.QueryBox(Min, Max, Found);
+            std::sort(Found.begin(), Found.end());
+            GEN_EXPECT(Found == Expected);
+
+            std::vector<int32_t> ByDistance(Samples.size());
+            for (int32_t i = 0; i < static_cast<int32_t>(Samples.size()); ++i) ByDistance[i] = i;
+            std::sort(ByDistance.begin(), ByDistance.end(), [&](int32_t A, int32_t B)
+                {
+                    const float DistA = FVec2::DistSquared(Samples[A], Point);
+                    const float DistB = FVec2::DistSquared(Samples[B], Point);
+                    return DistA < DistB || (DistA == DistB && A < B);
+                });
+            Found.clear();
+            Sampler.QueryNearest(Point, 8, Found);
+            GEN_EXPECT(Found == std::vector<int32_t>(ByDistance.begin(), ByDistance.begin() + 8));
+            GEN_EXPECT(Sampler.FindNearest(Point) == ByDistance[0]);
+            GEN_EXPECT(Sampler.FindNearest(Point, 1.f) == (FVec2::Distance(Samples[ByDistance[0]], Point) <= 1.f ? ByDistance[0] : -1));
+
+            // Filtered: odd sample indices only
+            Found.clear();
+            Sampler.QueryNearest(Point, 3, Found, std::numeric_limits<float>::max(), [](int32_t Index) { return Index % 2 == 1; });
+            std::vector<int32_t> Odd;
+            for (int32_t Index : ByDistance)
+            {
+                if (Index % 2 == 1 && Odd.size() < 3) Odd.push_back(Index);
+            }
+            GEN_EXPECT(Found == Odd);
+        }
+    }
+
+    void TestPoissonQueries()
+    {
+        FPoissonParams Params;
+        Params.Radius = 60.f;
+        Params.ChunkSize = 1500.f;
+
+        FPoissonSampler Sampler;
+        Sampler.Reset(Params, 5);
+        Sampler.GenerateParallel(SerialFor);
+        Sampler.AddSeed(FVec2(3000.f, 0.f));
+        ExpectQueriesMatchScan(Sampler);
+
+        Params.MinRadius = 20.f;
+        Params.MaxRadius = 200.f;
+        Params.RadiusAt = [](float X, float) { return X < 0.f ? 20.f : 200.f; };
+        Sampler.Reset(Params, 5);
+        Sampler.AddSeed(FVec2(0.f, 0.f));
+        while (Sampler.GetActiveCount() > 0)
+        {
+            Sampler.GenerateNextPoint();
+        }
+        ExpectQueriesMatchScan(Sampler);
+    }
+
+    void TestDLAStickOrderAndAdjacency()
+    {
+        FDLAParams Params;
+        Params.Bounds = 12;
+        Params.MaxWalkers = 300;
+
+        FDLASimulation Simulation;
+        Simulation.Reset(Params, 99);
+
+        std::vector<FInt3> Stuck;
+        for (int32_t Step = 0; Step < 400; ++Step)
+        {
+            Simulation.Step(GenHarness::ThreadedFor, Stuck);
+        }
+
+        const std::vector<FInt3>& Order = Simulation.GetAggregateOrder();
+        GEN_EXPECT(Order.size() > 20);
+        GEN_EXPECT(Order[0] == FInt3(0, 0, 0));
+        GEN_EXPECT(Stuck.size() + 1 == Order.size());
+
+        // Every voxel touched an earlier one when it stuck, and none is duplicated.
+        std::set<std::tuple<int32_t, int32_t, int32_t>> Seen;
+        for (size_t i = 0; i < Order.size(); ++i)
+        {
+            GEN_EXPECT(Seen.insert(std::make_tuple(Order[i].X, Order[i].Y, Order[i].Z)).second);
+            if (i == 0) continue;
+            bool bTouchesEarlier = false;
+            for (size_t j = 0; j < i && !bTouchesEarlier; ++j)
+            {
+                bTouchesEarlier = std::abs(Order[i].X - Order[j].X) <= 1 && std::abs(Order[i].Y - Order[j].Y) <= 1 && std::abs(Order[i].Z - Order[j].Z) <= 1;
+            }
+            GEN_EXPECT(bTouchesEarlier);
+        }
+
+        for (const FInt3& Walker : Simulation.GetWalkers())
+        {
+            GEN_EXPECT(std::abs(Walker.X) <= Params.Bounds && std::abs(Walker.Y) <= Params.Bounds && std::abs(Walker.Z) <= Params.Bounds);
+        }
+    }
+
+    void TestDLASnapshotResave()
+    {
+        FDLAParams Params;
+        Params.MaxWalkers = 2000;
+        Params.Bounds = 12;
+        FDLASimulation Simulation;
+        Simulation.Reset(Params, 4);
+        std::vector<FInt3> Stuck;
+        for (int32_t i = 0; i < 200; ++i)
+        {
+            Simulation.Step(SerialFor, Stuck);
+        }
+        GEN_EXPECT(Simulation.GetAggregateOrder().size() > 1);
+
+        FSnapshotWriter Writer;
+        Writer.AddSection(MakeVoxelRecords(Simulation.GetAggregateOrder()));
+        const std::vector<uint8_t> Saved = Writer.Finalize();
+
+        // Load as the actor does (into its own voxel list, the simulation stays at the seed), then save again
+        FSnapshotLayout Layout;
+        GEN_EXPECT(Layout.Parse(Saved.data(), Saved.size(), Saved.size()) == ESnapshotError::None);
+        uint64_t Count = 0;
+        const FSnapshotVoxel* Records = Layout.GetRecords<FSnapshotVoxel>(Saved.data(), Count);
+        std::vector<FInt3> Loaded;
+        for (uint64_t i = 0; i < Count; ++i)
+        {
+            Loaded.push_back(ToVoxel(Records[i]));
+        }
+
+        Writer.AddSection(MakeVoxelRecords(Loaded));
+        const std::vector<uint8_t> Resaved = Writer.Finalize();
+        GEN_EXPECT(Resaved == Saved);
+    }
+
+    void TestDLADeterministicAcrossThreading()
+    {
+        FDLAParams Params;
+        Params.Bounds = 10;
+
+        FDLASimulation Serial;
+        FDLASimulation Threaded;
+        Serial.Reset(Params, 5);
+        Threaded.Reset(Params, 5);
+
+        std::vector<FInt3> StuckA;
+        std::vector<FInt3> StuckB;
+        for (int32_t Step = 0; Step < 200; ++Step)
+        {
+            Serial.Step(SerialFor, StuckA);
+            Threaded.Step(GenHarness::ThreadedFor, StuckB);
+        }
+        GEN_EXPECT(StuckA == StuckB);
+    }
+
+    void TestDLAWalkerStepUnbiased()
+    {
+        // Every one of the 27 moves comes up equally often over whole cycles of the draw
+        int32_t Counts[27] = {};
+        for (uint32_t Draw = 0; Draw < 27u * 4096u; ++Draw)
+        {
+            const FInt3 Move = DecodeWalkerStep(Draw);
+            GEN_EXPECT(std::abs(Move.X) <= 1 && std::abs(Move.Y) <= 1 && std::abs(Move.Z) <= 1);
+            ++Counts[(Move.Z + 1) * 9 + (Move.Y + 1) * 3 + (Move.X + 1)];
+        }
+        for (int32_t Count : Counts)
+        {
+            GEN_EXPECT(Count == 4096);
+        }
+
+        // A walker on the simulation's xorshift32 stream does not drift: a biased mapping (342/341/341) would move it
+        // about -0.001 cells per step on every axis, five times the noise over this many steps
+        const int32_t Steps = 1 << 24;
+        uint32_t State = 0x9E3779B9u;
+        int64_t Sum[3] = {};
+        for (int32_t i = 0; i < Steps; ++i)
+        {
+            State ^= State << 13;
+            State ^= State >> 17;
+            State ^= State << 5;
+            const FInt3 Move = DecodeWalkerStep(State);
+            Sum[0] += Move.X;
+            Sum[1] += Move.Y;
+            Sum[2] += Move.Z;
+        }
+        for (int64_t Axis : Sum)
+        {
+            GEN_EXPECT(std::abs(static_cast<double>(Axis) / Steps) < 6e-4);
+        }
+    }
+
+    FInt2 ReferenceUlamPosition(int32_t Index)
+    {
+        // Straight port of the original step-by-step walk.
+        int32_t X = 0, Y = 0, DX = 1, DY = 0, SegmentLength = 1, SegmentPassed = 0, StepsInSegment = 0;
+        for (int32_t i = 1; i < Index; ++i)
+        {
+            X += DX;
+            Y += DY;
+            if (++StepsInSegment == SegmentLength)
+            {
+                StepsInSegment = 0;
+                ++SegmentPassed;
+                const int32_t Temp = DX;
+                DX = -DY;
+                DY = Temp;
+                if (SegmentPassed % 2 == 0) ++SegmentLength;
+            }
+        }
+        return FInt2(X, Y);
+    }
+
+    void TestGreedyMeshCube()
+    {
+        // One voxel: six faces, each wound counter-clockwise seen from outside
+        std::vector<FVoxelQuad> Quads;
+        GreedyMeshVoxels({ FInt3(2, -1, 0) }, {}, Quads);
+        GEN_EXPECT(Quads.size() == 6);
+        for (const FVoxelQuad& Quad : Quads)
+        {
+            FVec3 Corners[4];
+            GetQuadCorners(Quad, 100.f, 50.f, Corners);
+            const FVec3 Normal = FVec3::Cross(Corners[1] - Corners[0], Corners[2] - Corners[0]);
+            const FVec3 Outward = Corners[0] - FVec3(200.f, -100.f, 0.f);
+            GEN_EXPECT(FVec3::Dot(Normal, Outward) > 0.f);
+        }
+
+        // A solid 4x4x4 block still merges into one quad per side
+        std::vector<FInt3> Block;
+        for (int32_t X = 0; X < 4; ++X)
+            for (int32_t Y = 0; Y < 4; ++Y)
+                for (int32_t Z = 0; Z < 4; ++Z)
+                    Block.push_back(FInt3(X, Y, Z));
+        Quads.clear();
+        GreedyMeshVoxels(Block, {}, Quads);
+        GEN_EXPECT(Quads.size() == 6);
+    }
+
+    void TestGreedyMeshCoversExposedFaces()
+    {
+        // Random blob, partly meshed, the rest occluding
+        FGenRandom Random(11);
+        std::set<std::tuple<int32_t, int32_t, int32_t>> Solid;
+        std::vector<FInt3> Meshed;
+        std::vector<FInt3> Occluders;
+        for (int32_t i = 0; i < 1500; ++i)
+        {
+            const FInt3 Voxel(Random.RandRange(-6, 6), Random.RandRange(-6, 6), Random.RandRange(-6, 6));
+            if (!Solid.insert(std::make_tuple(Voxel.X, Voxel.Y, Voxel.Z)).second) continue;
+            (Random.RandRange(0, 3) == 0 ? Occluders : Meshed).push_back(Voxel);
+        }
+        auto IsSolid = [&Solid](const FInt3& Voxel) { return Solid.count(std::make_tuple(Voxel.X, Voxel.Y, Voxel.Z)) != 0; };
+
+        // Brute force: every (voxel, axis, side) face of a meshed voxel with an empty neighbour
+        std::set<std::tuple<int32_t, int32_t, int32_t, int32_t, int32_t>> Expected;
+        for (const FInt3& Voxel : Meshed)
+        {
+            for (int32_t Axis = 0; Axis < 3; ++Axis)
+            {
+                for (int32_t Side = 0; Side < 2; ++Side)
+                {
+                    FInt3 Neighbor = Voxel;
+                    Neighbor[Axis] += Side == 0 ? 1 : -1;
+                    if (!IsSolid(Neighbor)) Expected.insert(std::make_tuple(Voxel.X, Voxel.Y, Voxel.Z, Axis, Side));
+                }
+            }
+        }
+
+        std::vector<FVoxelQuad> Quads;
+        GreedyMeshVoxels(Meshed, Occluders, Quads);
+
+        // The quads tile exactly the exposed faces, none twice
+        std::set<std::tuple<int32_t, int32_t, int32_t, int32_t, int32_t>> Covered;
+        size_t Area = 0;
+        for (const FVoxelQuad& Quad : Quads)
+        {
+            for (int32_t X = Quad.Min.X; X <= Quad.Max.X; ++X)
+                for (int32_t Y = Quad.Min.Y; Y <= Quad.Max.Y; ++Y)
+                    for (int32_t Z = Quad.Min.Z; Z <= Quad.Max.Z; ++Z)
+                    {
+                        Covered.insert(std::make_tuple(X, Y, Z, Quad.Axis, Quad.bPositive ? 0 : 1));
+                        ++Area;
+                    }
+        }
+        GEN_EXPECT(Area == Covered.size());
+        GEN_EXPECT(Covered == Expected);
+        GEN_EXPECT(Quads.size() < Expected.size());
+    }
+
+    void TestUlamSpiral()
+    {
+        for (int32_t Index = 1; Index <= 20000; ++Index)
+        {
+            GEN_EXPECT(GetUlamSpiralPosition(Index) == ReferenceUlamPosition(Index));
+        }
+    }
+
+    void TestIsPrime()
+    {
+        int32_t Count = 0;
+        for (int32_t i = -5; i <= 10000; ++i)
+        {
+            Count += IsPrime(i) ? 1 : 0;
+        }
+        GEN_EXPECT(Count == 1229);
+        GEN_EXPECT(IsPrime(2147483647));
+        GEN_EXPECT(!IsPrime(2147483646));
+    }
+
+    void TestSnapshotRoundTrip()
+    {
+        std::vector<FSnapshotCircle> Circles = { { 1.f, 2.f, 3.f, 4.f, 10, 20, 30, 255 }, { -5.f, 6.f, 7.f, 8.f, 0, 0, 0, 255 } };
+        std::vector<FSnapshotVoxel> Voxels;
+        for (int16_t i = 0; i < 1000; ++i)
+        {
+            Voxels.push_back({ i, static_cast<int16_t>(-i), 3, 0 });
+        }
+
+        FSnapshotWriter Writer;
+        Writer.AddSection(Circles);
+        Writer.AddSection(Voxels);
+        const std::vector<uint8_t> Image = Writer.Finalize();
+
+        FSnapshotLayout Layout;
+        GEN_EXPECT(Layout.Parse(Image.data(), Image.size(), Image.size()) == ESnapshotError::None);
+        GEN_EXPECT(Layout.GetRecordCount<FSnapshotCircle>() == 2);
+        GEN_EXPECT(Layout.GetRecordCount<FSnapshotVoxel>() == 1000);
+        GEN_EXPECT(Layout.GetRecordCount<FSnapshotPrime>() == 0);
+
+        uint64_t Count = 0;
+        const FSnapshotCircle* ReadCircles = Layout.GetRecords<FSnapshotCircle>(Image.data(), Count);
+        GEN_EXPECT(Count == 2 && ReadCircles[1].X == -5.f && ReadCircles[0].G == 20);
+        GEN_EXPECT(reinterpret_cast<uintptr_t>(ReadCircles) % alignof(FSnapshotCircle) == 0);
+
+        // Partial range for streaming: records [990, 1000) only
+        uint64_t Offset = 0;
+        uint64_t Size = 0;
+        GEN_EXPECT(Layout.GetRecordRange<FSnapshotVoxel>(990, 100, Offset, Size));
+        GEN_EXPECT(Size == 10 * sizeof(FSnapshotVoxel));
+        const FSnapshotVoxel* Tail = reinterpret_cast<const FSnapshotVoxel*>(Image.data() + Offset);
+        GEN_EXPECT(Tail[0].X == 990 && Tail[9].Y == -999);
+
+        // The table alone is enough to parse
+        const uint64_t TableSize = FSnapshotLayout::GetTableSize(Image.data(), Image.size());
+        GEN_EXPECT(Layout.Parse(Image.data(), TableSize, Image.size()) == ESnapshotError::None);
+
+        std::vector<uint8_t> Truncated(Image.begin(), Image.end() - 16);
+        GEN_EXPECT(Layout.Parse(Truncated.data(), Truncated.size(), Truncated.size()) == ESnapshotError::Corrupt);
+        std::vector<uint8_t> BadMagic = Image;
+        BadMagic[0] ^= 0xFF;
+        GEN_EXPECT(Layout.Parse(BadMagic.data(), BadMagic.size(), BadMagic.size()) == ESnapshotError::BadMagic);
+
+        // Poisson samples keep their rotation; a version 1 file still parses, with the old record in the same section
+        const std::vector<FSnapshotPoissonSample> Samples = { { 1.f, 2.f, 3.f, 0.f, 0.f, 0.7071068f, 0.7071068f, 2, 0, 10, 20, 30, 255 } };
+        Writer.AddSection(Samples);
+        const std::vector<uint8_t> PoissonImage = Writer.Finalize();
+        GEN_EXPECT(Layout.Parse(PoissonImage.data(), PoissonImage.size(), PoissonImage.size()) == ESnapshotError::None);
+        const FSnapshotPoissonSample* ReadSamples = Layout.GetRecords<FSnapshotPoissonSample>(PoissonImage.data(), Count);
+        GEN_EXPECT(Count == 1 && ReadSamples[0].QZ == Samples[0].QZ && ReadSamples[0].QW == Samples[0].QW && ReadSamples[0].MeshId == 2);
+        GEN_EXPECT(Layout.GetRecordCount<FSnapshotPoissonSampleV1>() == 0);
+
+        const std::vector<FSnapshotPoissonSampleV1> Legacy = { { 1.f, 2.f, 3.f, 2, 0, 10, 20, 30, 255 } };
+        Writer.AddSection(Legacy);
+        std::vector<uint8_t> LegacyImage = Writer.Finalize();
+        const uint16_t LegacyVersion = 1;
+        std::memcpy(LegacyImage.data() + offsetof(FSnapshotHeader, Version), &LegacyVersion, sizeof(LegacyVersion));
+        GEN_EXPECT(Layout.Parse(LegacyImage.data(), LegacyImage.size(), LegacyImage.size()) == ESnapshotError::None);
+        GEN_EXPECT(Layout.GetRecordCount<FSnapshotPoissonSampleV1>() == 1);
+        GEN_EXPECT(Layout.GetRecordCount<FSnapshotPoissonSample>() == 0);
+
+        std::vector<uint8_t> Future = LegacyImage;
+        const uint16_t FutureVersion = SnapshotVersion + 1;
+        std::memcpy(Future.data() + offsetof(FSnapshotHeader, Version), &FutureVersion, sizeof(FutureVersion));
+        GEN_EXPECT(Layout.Parse(Future.data(), Future.size(), Future.size()) == ESnapshotError::UnsupportedVersion);
+    }
+    void TestReplayRoundTrip()
+    {
+        // A DLA-like walk: one voxel per event, several per frame, a colour and size change midway
+        std::vector<FReplayEvent> Events;
+        FGenRandom Random(5);
+        FInt3 Voxel(0, 0, 0);
+        for (int32_t i = 0; i < 2000; ++i)
+        {
+            FReplayEvent Event;
+            Event.Type = i % 7 == 0 ? EReplayEventType::Spawn : EReplayEventType::Stick;
+            Event.Frame = static_cast<uint32_t>(i / 3);
+            Event.Time = Event.Frame / 60.0;
+            Voxel.X += Random.RandRange(-1, 1);
+            Voxel.Y += Random.RandRange(-1, 1);
+            Voxel.Z += Random.RandRange(-1, 1);
+            Event.Position = FVec3(Voxel.X * 100.f, Voxel.Y * 100.f, Voxel.Z * 100.f + 0.25f);
+            Event.Size = i < 1000 ? 50.f : 12.34f;
+            Event.Id = i % 3;
+            Event.Rotation = FVec3(0.f, i * 0.5f, -90.f);
+            Event.R = i < 1000 ? 10 : 200;
+            Events.push_back(Event);
+        }
+
+        FReplayWriter Writer;
+        Writer.Reset();
+        for (const FReplayEvent& Event : Events)
+        {
+            Writer.Add(Event);
+        }
+        const std::vector<uint8_t> Image = Writer.Finalize();
+        GEN_EXPECT(Writer.GetEventCount() == Events.size());
+        // Deltas keep a typical event well under a raw record
+        GEN_EXPECT(Writer.GetPayloadSize() < Events.size() * 16);
+
+        FReplayReader Reader;
+        GEN_EXPECT(Reader.Open(Image.data(), Image.size()) == ESnapshotError::None);
+        GEN_EXPECT(Reader.GetHeader().LastFrame == Events.back().Frame);
+        FReplayEvent Read;
+        size_t Count = 0;
+        while (Reader.Next(Read))
+        {
+            const FReplayEvent& Expected = Events[Count++];
+            GEN_EXPECT(Read.Type == Expected.Type);
+            GEN_EXPECT(Read.Frame == Expected.Frame);
+            GEN_EXPECT(std::abs(Read.Time - Expected.Time) <= 0.0005);
+            const FVec3 Error = Read.Position - Expected.Position;
+            GEN_EXPECT(FVec3::Dot(Error, Error) <= 0.0001f);
+            GEN_EXPECT(std::abs(Read.Size - Expected.Size) <= 0.005f);
+            GEN_EXPECT(Read.Id == Expected.Id);
+            GEN_EXPECT(std::abs(Read.Rotation.Y - Expected.Rotation.Y) <= 0.005f && std::abs(Read.Rotation.Z + 90.f) <= 0.005f);
+            GEN_EXPECT(Read.R == Expected.R && Read.G == 255);
+        }
+        GEN_EXPECT(Count == Events.size());
+        GEN_EXPECT(Reader.GetError() == ESnapshotError::None);
+
+        std::vector<uint8_t> Truncated(Image.begin(), Image.end() - 5);
+        GEN_EXPECT(Reader.Open(Truncated.data(), Truncated.size()) == ESnapshotError::Corrupt);
+        std::vector<uint8_t> BadMagic = Image;
+        BadMagic[0] ^= 0xFF;
+        GEN_EXPECT(Reader.Open(BadMagic.data(), BadMagic.size()) == ESnapshotError::BadMagic);
+
+        // A header that promises more events than the stream holds runs dry without reading past the end
+        std::vector<uint8_t> Overcounted = Image;
+        const uint32_t MoreEvents = static_cast<uint32_t>(Events.size() + 1);
+        std::memcpy(Overcounted.data() + offsetof(FReplayHeader, EventCount), &MoreEvents, sizeof(MoreEvents));
+        GEN_EXPECT(Reader.Open(Overcounted.data(), Overcounted.size()) == ESnapshotError::None);
+        Count = 0;
+        while (Reader.Next(Read))
+        {
+            ++Count;
+        }
+        GEN_EXPECT(Count == Events.size());
+        GEN_EXPECT(Reader.GetError() == ESnapshotError::Corrupt);
+    }
+}
+
+int main()
+{
+    struct FTest { const char* Name; void (*Fn)(); };
+    const FTest Tests[] = {
+        { "CirclePackingNoOverlap", TestCirclePackingNoOverlap },
+        { "CirclePackingFrontChain", TestCirclePackingFrontChain },
+        { "CirclePackingGrowUntilContact", TestCirclePackingGrowUntilContact },
+        { "CirclePackingMaskSampling", TestCirclePackingMaskSampling },
+        { "CirclePackingMasked", TestCirclePackingMasked },
+        { "CirclePackingGrowth", TestCirclePackingGrowth },
+        { "PoissonMinDistance", TestPoissonMinDistance },
+        { "PoissonParallelMinDistance", TestPoissonParallelMinDistance },
+        { "PoissonVariableRadius", TestPoissonVariableRadius },
+        { "PoissonQueries", TestPoissonQueries },
+        { "DLAStickOrderAndAdjacency", TestDLAStickOrderAndAdjacency },
+        { "DLADeterministicAcrossThreading", TestDLADeterministicAcrossThreading },
+        { "DLAWalkerStepUnbiased", TestDLAWalkerStepUnbiased },
+        { "DLASnapshotResave", TestDLASnapshotResave },
+        { "GreedyMeshCube", TestGreedyMeshCube },
+        { "GreedyMeshCoversExposedFaces", TestGreedyMeshCoversExposedFaces },
+        { "UlamSpiral", TestUlamSpiral },
+        { "IsPrime", TestIsPrime },
+        { "SnapshotRoundTrip", TestSnapshotRoundTrip },
+        { "ReplayRoundTrip", TestReplayRoundTrip },
+    };
+
+    for (const FTest& Test : Tests)
+    {
+        const int32_t Before = Failures;
+        Test.Fn();
+        std::printf("[%s] %s\n", Failures == Before ? "PASS" : "FAIL", Test.Name);
+    }
+    return Failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// Shared helpers for the native generator core harness.
+
+#include "GenCoreTypes.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace GenHarness
+{
+    // std::thread stand-in for the engine's ParallelFor.
+    inline void ThreadedFor(int32_t Num, const std::function<void(int32_t)>& Body)
+    {
+        const int32_t NumThreads = std::max(1, std::min<int32_t>(Num, static_cast<int32_t>(std::thread::hardware_concurrency())));
+        std::atomic<int32_t> Next(0);
+        std::vector<std::thread> Threads;
+        Threads.reserve(NumThreads);
+        for (int32_t t = 0; t < NumThreads; ++t)
+        {
+            Threads.emplace_back([&]()
+                {
+                    for (int32_t i = Next++; i < Num; i = Next++)
+                    {
+                        Body(i);
+                    }
+                });
+        }
+        for (std::thread& Thread : Threads)
+        {
+            Thread.join();
+        }
+    }
+}